@@ -81,8 +81,8 @@ void CassandraDB::cleanup() {
 	return;
 }
 
-Status CassandraDB::read(const std::string &table, const std::string &key,
-						const std::vector<std::string>& fields, std::vector<stringPair> &result) {
+Status CassandraDB::read(const std::string &table, std::string_view key,
+						FieldList fields, ReadResult &result) {
 
 	if((m_session == nullptr) || (m_cluster == nullptr))
 		return Status::FORBIDDEN;
@@ -132,12 +132,13 @@ Status CassandraDB::read(const std::string &table, const std::string &key,
 		}
 	}
 	else // get columns that are given in the "fields"
-		columnNamesVec = fields;
+		columnNamesVec.assign(fields.begin(), fields.end());
 
 	//When column names exist
 	//read values associated with columns
-	std::string queryStr = "SELECT * FROM " + m_keyspace + "." + table + " WHERE " + YCSB_KEY + " = '"+ key + "';";
-	CassStatement* statement = cass_statement_new(queryStr.c_str(), 0);
+	std::string queryStr = "SELECT * FROM " + m_keyspace + "." + table + " WHERE " + YCSB_KEY + " = ?;";
+	CassStatement* statement = cass_statement_new(queryStr.c_str(), 1);
+	cass_statement_bind_string_n(statement, 0, key.data(), key.size());
 	
 	CassFuture* result_future = cass_session_execute(m_session, statement);
 	cass_statement_free(statement);
@@ -171,8 +172,8 @@ Status CassandraDB::read(const std::string &table, const std::string &key,
 	return Status::OK;
 }
 
-Status CassandraDB::scan(const std::string &table, const std::string &startkey, int recordcount,
-						std::vector<std::string>& fields, std::vector<std::vector<stringPair>> &result) {
+Status CassandraDB::scan(const std::string &table, std::string_view startkey, int recordcount,
+						FieldList fields, ScanResult &result) {
 
 	if((m_session == nullptr) || (m_cluster == nullptr))
 		return Status::FORBIDDEN;
@@ -184,8 +185,8 @@ Status CassandraDB::scan(const std::string &table, const std::string &startkey,
 	return Status::FORBIDDEN;
 }
 
-Status CassandraDB::update(const std::string &table, const std::string &key,
-						std::vector<stringPair> values) {
+Status CassandraDB::update(const std::string &table, std::string_view key,
+						RecordView values) {
 	if((m_session == nullptr) || (m_cluster == nullptr))
 		return Status::FORBIDDEN;
 
@@ -195,32 +196,32 @@ Status CassandraDB::update(const std::string &table, const std::string &key,
 
 	CassError rc;
 
-	std::string queryStr1 = "UPDATE " + m_keyspace + "." + table + " SET ";
-	std::string queryStr2 = "";
-	std::string queryStr3 = " WHERE " + YCSB_KEY + " = '"+ key + "';";
-
-	std::vector<stringPair>::iterator it;
-	for(it = values.begin(); it != values.end(); ++it) {
-		if(it == values.begin())
-			queryStr2 = it->first + " = '" + it->second + "'";
+	std::string queryStr = "UPDATE " + m_keyspace + "." + table + " SET ";
+	for(std::size_t i = 0; i < values.size(); ++i) {
+		if(i > 0)
+			queryStr += ", ";
+		queryStr.append(values[i].field.data(), values[i].field.size()).append(" = ?");
+	}
+	queryStr += " WHERE " + YCSB_KEY + " = ?;";
+
+	/* Values are bound rather than pasted into the query, so they are not copied
+	   into the CQL text and need no quoting */
+	CassStatement* statement = cass_statement_new(queryStr.c_str(), values.size() + 1);
+	for(std::size_t i = 0; i < values.size(); ++i) {
+		if(values[i].type == BINARY_PAYLOAD)
+			cass_statement_bind_bytes(statement, i, reinterpret_cast<const cass_byte_t*>(values[i].value.data()),
+									  values[i].value.size());
 		else
-			queryStr2 += ", " + it->first + " = '" + it->second + "'";
+			cass_statement_bind_string_n(statement, i, values[i].value.data(), values[i].value.size());
 	}
-
-	std::string queryStr = queryStr1 + queryStr2 + queryStr3;
-	CassStatement* statement = cass_statement_new(queryStr.c_str(), 0);
+	cass_statement_bind_string_n(statement, values.size(), key.data(), key.size());
 	if((rc=ExecuteQuery(statement)) != CASS_OK)
 		return Status::FORBIDDEN;
 
 	return Status::OK;
 }
 
-Status CassandraDB::insert(const std::string &table, const std::string &key,
-						std::vector<stringPair> &values) {
-
-	if((m_session == nullptr) || (m_cluster == nullptr))
-		return Status::FORBIDDEN;
-
+const CassPrepared* CassandraDB::PrepareInsert(const std::string &table, RecordView values) {
 	if(!doesTableExist(m_keyspace, table)) {
 		//Create table in 'm_keyspace' to store key and associated values
 		CreateTablewPrimaryKey(m_keyspace, table);
@@ -231,13 +232,11 @@ Status CassandraDB::insert(const std::string &table, const std::string &key,
 	std::string queryStr2 = "";
 	std::string queryStr3 = "?";
 
-	std::vector<stringPair>::iterator it;
-
-	for(it = values.begin(); it != values.end(); ++it){
-		if(!doesColumnExist(m_keyspace,table,it->first)) {
-			CreateColumn(m_keyspace, table, it->first);
+	for(const FieldValue &v : values){
+		if(!doesColumnExist(m_keyspace,table,v.field)) {
+			CreateColumn(m_keyspace, table, v.field, v.type);
 		}
-		queryStr2 = queryStr2 + "," + it->first;
+		queryStr2.append(",").append(v.field.data(), v.field.size());
 		queryStr3 += ",?";
 	}
 
@@ -252,7 +251,7 @@ Status CassandraDB::insert(const std::string &table, const std::string &key,
 	if (rc != CASS_OK) {
 		/* Handle error */
 		cass_future_free(prepare_future);
-		return Status::FORBIDDEN;
+		return nullptr;
 	}
 
 	/* Get the prepared object from the future */
@@ -260,19 +259,41 @@ Status CassandraDB::insert(const std::string &table, const std::string &key,
 
 	/* The future can be freed immediately after getting the prepared object */
 	cass_future_free(prepare_future);
+	return prepared;
+}
 
+CassStatement* CassandraDB::BindInsert(const CassPrepared* prepared, std::string_view key, RecordView values) {
 	/* The prepared object can now be used to create statements that can be executed */
 	CassStatement* statement = cass_prepared_bind(prepared);
 	/* Bind Primary Key */
-	cass_statement_bind_string_by_name(statement, YCSB_KEY.c_str(), key.c_str());
-
-	/* Bind variables by name this time (this can only be done with prepared statements)*/
-	for(it = values.begin(); it != values.end(); ++it) {
-		cass_statement_bind_string_by_name(statement, it->first.c_str(), it->second.c_str());
+	cass_statement_bind_string_by_name_n(statement, YCSB_KEY.data(), YCSB_KEY.size(), key.data(), key.size());
+
+	/* Bind variables by name this time (this can only be done with prepared statements).
+	   The _n variants take lengths, so the views are bound without NUL terminated copies. */
+	for(const FieldValue &v : values) {
+		if(v.type == BINARY_PAYLOAD)
+			cass_statement_bind_bytes_by_name_n(statement, v.field.data(), v.field.size(),
+												reinterpret_cast<const cass_byte_t*>(v.value.data()), v.value.size());
+		else
+			cass_statement_bind_string_by_name_n(statement, v.field.data(), v.field.size(),
+												 v.value.data(), v.value.size());
 	}
+	return statement;
+}
+
+Status CassandraDB::insert(const std::string &table, std::string_view key,
+						RecordView values) {
+
+	if((m_session == nullptr) || (m_cluster == nullptr))
+		return Status::FORBIDDEN;
 
+	const CassPrepared* prepared = PrepareInsert(table, values);
+	if(prepared == nullptr)
+		return Status::FORBIDDEN;
+
+	CassError rc;
 	/* Execute statement (same a the non-prepared code) */
-	if((rc=ExecuteQuery(statement)) != CASS_OK) {
+	if((rc=ExecuteQuery(BindInsert(prepared, key, values))) != CASS_OK) {
 		/* The prepared object must be freed */
 		cass_prepared_free(prepared);
 		return Status::ERROR;
@@ -283,12 +304,44 @@ Status CassandraDB::insert(const std::string &table, const std::string &key,
 	return Status::OK;
 }
 
-Status CassandraDB::Delete(const std::string &table, const std::string &key) {
+Status CassandraDB::batchInsert(const std::string &table, const std::vector<KeyedRecord> &records) {
+	if((m_session == nullptr) || (m_cluster == nullptr))
+		return Status::FORBIDDEN;
+	if(records.empty())
+		return Status::OK;
+
+	/* The records of a load batch share the table's field layout, so one
+	   prepared statement serves all of them */
+	const CassPrepared* prepared = PrepareInsert(table, records.front().values);
+	if(prepared == nullptr)
+		return Status::FORBIDDEN;
+
+	/* Unlogged: no batch log write, the batch only saves round trips. The key
+	   is the partition key, so each statement targets its own partition and
+	   the batch is kept to batchsize statements */
+	CassBatch* batch = cass_batch_new(CASS_BATCH_TYPE_UNLOGGED);
+	for(const KeyedRecord &record : records) {
+		CassStatement* statement = BindInsert(prepared, record.key, record.values);
+		cass_batch_add_statement(batch, statement);
+		/* The batch keeps its own reference to the statement */
+		cass_statement_free(statement);
+	}
+
+	CassFuture* batch_future = cass_session_execute_batch(m_session, batch);
+	cass_batch_free(batch);
+	CassError rc = cass_future_error_code(batch_future);
+	cass_future_free(batch_future);
+	cass_prepared_free(prepared);
+	return rc == CASS_OK ? Status::OK : Status::ERROR;
+}
+
+Status CassandraDB::Delete(const std::string &table, std::string_view key) {
 	if((m_session == nullptr) || (m_cluster == nullptr))
 		return Status::FORBIDDEN;
 	CassError rc;
-	std::string queryStr = "DELETE FROM " + m_keyspace + "." + table + " WHERE " + YCSB_KEY + " = '"+ key + "';";
-	CassStatement* statement = cass_statement_new(queryStr.c_str(), 0);
+	std::string queryStr = "DELETE FROM " + m_keyspace + "." + table + " WHERE " + YCSB_KEY + " = ?;";
+	CassStatement* statement = cass_statement_new(queryStr.c_str(), 1);
+	cass_statement_bind_string_n(statement, 0, key.data(), key.size());
 	if((rc=ExecuteQuery(statement)) != CASS_OK)
 		return Status::FORBIDDEN;
 	return Status::OK;
@@ -320,14 +373,14 @@ bool CassandraDB::doesTableExist(const std::string &in_keyspace, const std::stri
 	return false;
 }
 
-bool CassandraDB::doesColumnExist(const std::string &in_keyspace, const std::string &in_table, const std::string &in_column) {
+bool CassandraDB::doesColumnExist(const std::string &in_keyspace, const std::string &in_table, std::string_view in_column) {
 	const CassSchemaMeta* schema_meta = cass_session_get_schema_meta(m_session);
 	const CassKeyspaceMeta* keyspace_meta = cass_schema_meta_keyspace_by_name(schema_meta, in_keyspace.c_str());
 
 	if (keyspace_meta != NULL) {
 		const CassTableMeta* table_meta = cass_keyspace_meta_table_by_name(keyspace_meta, in_table.c_str());
 		if (table_meta != NULL) {
-			const CassColumnMeta* column_meta = cass_table_meta_column_by_name(table_meta, in_column.c_str());
+			const CassColumnMeta* column_meta = cass_table_meta_column_by_name_n(table_meta, in_column.data(), in_column.size());
 			if (column_meta != NULL) {
 				cass_schema_meta_free(schema_meta);
 				return true;
@@ -348,9 +401,11 @@ bool CassandraDB::CreateTablewPrimaryKey(const std::string &in_keyspace, const s
 	return true;
 }
 
-bool CassandraDB::CreateColumn(const std::string &in_keyspace, const std::string &in_table, const std::string &in_column) {
+bool CassandraDB::CreateColumn(const std::string &in_keyspace, const std::string &in_table, std::string_view in_column,
+							   PayloadType in_type) {
 	CassError rc;
-	std::string queryStr = "ALTER TABLE " + in_keyspace + "." + in_table + " ADD " + in_column + " text;" ;
+	std::string queryStr = "ALTER TABLE " + in_keyspace + "." + in_table + " ADD ";
+	queryStr.append(in_column.data(), in_column.size()).append(in_type == BINARY_PAYLOAD ? " blob;" : " text;");
 	CassStatement* statement = cass_statement_new(queryStr.c_str(), 0);
 	if((rc=ExecuteQuery(statement)) != CASS_OK) {
 		return false;
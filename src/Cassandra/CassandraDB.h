@@ -73,22 +73,29 @@ public:
 	
 	void init() override;
 	void cleanup() override;
-	Status read(const std::string &table, const std::string &key,
-					const std::vector<std::string>& fields, std::vector<stringPair> &result) override;
-	Status scan(const std::string &table, const std::string &startkey, int recordcount,
-					std::vector<std::string>& fields, std::vector<std::vector<stringPair>> &result) override;
-	Status update(const std::string &table, const std::string &key, 
-					std::vector<stringPair> values) override;
-	Status insert(const std::string &table, const std::string &key, 
-					std::vector<stringPair> &values) override;
-	Status Delete(const std::string &table, const std::string &key) override;
+	Status read(const std::string &table, std::string_view key,
+					FieldList fields, ReadResult &result) override;
+	Status scan(const std::string &table, std::string_view startkey, int recordcount,
+					FieldList fields, ScanResult &result) override;
+	Status update(const std::string &table, std::string_view key, 
+					RecordView values) override;
+	Status insert(const std::string &table, std::string_view key, 
+					RecordView values) override;
+	Status Delete(const std::string &table, std::string_view key) override;
+	Status batchInsert(const std::string &table, const std::vector<KeyedRecord> &records) override;
 
 	CassError ExecuteQuery(CassStatement*);
 	void setKeyspace(std::string &in_keyspace);
 	bool doesTableExist(const std::string &in_keyspace, const std::string &in_table);
-	bool doesColumnExist(const std::string &in_keyspace, const std::string &in_table, const std::string &in_column);
+	bool doesColumnExist(const std::string &in_keyspace, const std::string &in_table, std::string_view in_column);
 	bool CreateTablewPrimaryKey(const std::string &in_keyspace, const std::string &in_table);
-	bool CreateColumn(const std::string &in_keyspace, const std::string &in_table, const std::string &in_column);
+	/* Binary payloads go to blob columns, everything else to text columns */
+	bool CreateColumn(const std::string &in_keyspace, const std::string &in_table, std::string_view in_column,
+					  PayloadType in_type = ASCII_PAYLOAD);
+	/* Create the table and columns values need and prepare an INSERT for them; nullptr on error */
+	const CassPrepared* PrepareInsert(const std::string &table, RecordView values);
+	/* Bind a record to a prepared INSERT */
+	CassStatement* BindInsert(const CassPrepared* prepared, std::string_view key, RecordView values);
 
 protected:
 
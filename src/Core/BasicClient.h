@@ -0,0 +1,249 @@
+// BasicClient.h
+
+#ifndef _DBBENCHMARK_BASICCLIENT_H_
+#define _DBBENCHMARK_BASICCLIENT_H_
+
+#include <memory>
+#include <typeinfo>
+
+#include "Client.h"
+#include "Core/Generators/ScrambledZipfianGenerator.h"
+#include "Core/Generators/SkewedLatestGenerator.h"
+#include "Core/Generators/UniformGenerator.h"
+
+namespace dbbenchmark {
+/**
+*   \brief A Client compiled for one workload configuration.
+*   \details Client calls the workload, its generators and the database through virtual functions
+*       and checks read_all_fields() and write_all_fields() on every operation. BasicClient fixes
+*       all of them at compile time: the workload is called by qualified name, keys are drawn by
+*       KeyChooser, a final generator class, and the field modes are template parameters, so the
+*       loop in DoTransactions() makes no indirect call besides the one into the database. That
+*       one disappears too if Database is a final class.
+*       CreateClient() picks an instantiation once at startup and falls back to the generic Client
+*       for configurations that have none. Both produce the same operations from the same workload.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+template <typename Workload, typename KeyChooser, typename Database,
+          bool ReadAllFields = true, bool WriteAllFields = false>
+class BasicClient : public Client {
+  public:
+    /** The dynamic types of db and wl must be Database and Workload, and every table of wl must
+    * choose keys with a KeyChooser; CreateClient() checks this.
+    */
+    BasicClient(std::shared_ptr<DB> db, std::shared_ptr<CoreWorkload> wl) :
+        Client(db, wl), concreteDB(static_cast<Database *>(db.get())),
+        concreteWorkload(static_cast<Workload *>(wl.get())) { }
+
+    bool DoTransaction() override { return Transaction(); }
+    int DoTransactions(int count) override;
+    bool DoOperation(const OperationRecord &record) override { return Execute(record); }
+
+  protected:
+    bool Transaction();
+    bool Execute(const OperationRecord &record);
+    Status Read(const OperationRecord &record);
+    Status ReadModifyWrite(const OperationRecord &record);
+    Status Scan(const OperationRecord &record);
+    Status Update(const OperationRecord &record);
+    Status Insert(const OperationRecord &record);
+    Status Delete(const OperationRecord &record);
+    /// Fields a read or scan of record asks for.
+    FieldList ReadFields(const OperationRecord &record) const;
+    /// Build the values an update or read-modify-write writes, returns their version.
+    uint64_t BuildWrite(const OperationRecord &record);
+
+    Database *concreteDB;
+    Workload *concreteWorkload;
+};
+
+template <typename W, typename K, typename D, bool R, bool U>
+inline int BasicClient<W, K, D, R, U>::DoTransactions(int count) {
+  if (this->concreteDB->pipelineDepth() > 1) {
+    // Windows are built once per round trip, not per operation.
+    return Client::DoTransactions(count);
+  }
+  int oks = 0;
+  for (int i = 0; i < count; ++i) {
+    oks += Transaction();
+  }
+  return oks;
+}
+
+template <typename W, typename K, typename D, bool R, bool U>
+inline bool BasicClient<W, K, D, R, U>::Transaction() {
+  OperationRecord record;
+  this->concreteWorkload->template NextOperationRecordWith<K>(record);
+  bool isOk = Execute(record);
+  if (record.operation == INSERT) {
+    // Acknowledge even on failure, otherwise the limit would stall here.
+    this->concreteWorkload->W::AcknowledgeInsert(record.keyNum, record.table);
+  }
+  return isOk;
+}
+
+template <typename W, typename K, typename D, bool R, bool U>
+inline bool BasicClient<W, K, D, R, U>::Execute(const OperationRecord &record) {
+  Status tmpStatus;
+  switch (record.operation) {
+    case READ:
+      tmpStatus = Read(record);
+      break;
+    case UPDATE:
+      tmpStatus = Update(record);
+      break;
+    case INSERT:
+      tmpStatus = Insert(record);
+      break;
+    case SCAN:
+      tmpStatus = Scan(record);
+      break;
+    case READMODIFYWRITE:
+      tmpStatus = ReadModifyWrite(record);
+      break;
+    case DELETE:
+      tmpStatus = Delete(record);
+      break;
+    default:
+      throw NotImplementedException("Operation request is not recognized!");
+  }
+  return (tmpStatus == Status::OK);
+}
+
+template <typename W, typename K, typename D, bool R, bool U>
+inline FieldList BasicClient<W, K, D, R, U>::ReadFields(const OperationRecord &record) const {
+  if constexpr (R) {
+    return FieldList();
+  } else {
+    return this->concreteWorkload->SingleField(record.fieldId, record.table);
+  }
+}
+
+template <typename W, typename K, typename D, bool R, bool U>
+inline uint64_t BasicClient<W, K, D, R, U>::BuildWrite(const OperationRecord &record) {
+  this->values.clear();
+  if constexpr (U) {
+    return this->concreteWorkload->W::BuildValues(record, this->values);
+  } else {
+    return this->concreteWorkload->W::BuildUpdate(record, this->values);
+  }
+}
+
+template <typename W, typename K, typename D, bool R, bool U>
+inline Status BasicClient<W, K, D, R, U>::Read(const OperationRecord &record) {
+  const std::string &table = this->concreteWorkload->TableName(record.table);
+  std::string_view key = this->concreteWorkload->BuildKeyName(record.keyNum, this->keyBuffer);
+  this->readResult.clear();
+  Status status = this->concreteDB->read(table, key, ReadFields(record), this->readResult);
+  VerifyRead(record, this->readResult, status);
+  return status;
+}
+
+template <typename W, typename K, typename D, bool R, bool U>
+inline Status BasicClient<W, K, D, R, U>::ReadModifyWrite(const OperationRecord &record) {
+  const std::string &table = this->concreteWorkload->TableName(record.table);
+  std::string_view key = this->concreteWorkload->BuildKeyName(record.keyNum, this->keyBuffer);
+  this->readResult.clear();
+  VerifyRead(record, this->readResult,
+             this->concreteDB->read(table, key, ReadFields(record), this->readResult));
+  uint64_t version = BuildWrite(record);
+  Status status = this->concreteDB->update(table, key, this->values);
+  RecordWrite(record, version, U, status);
+  return status;
+}
+
+template <typename W, typename K, typename D, bool R, bool U>
+inline Status BasicClient<W, K, D, R, U>::Scan(const OperationRecord &record) {
+  const std::string &table = this->concreteWorkload->TableName(record.table);
+  std::string_view key = this->concreteWorkload->BuildKeyName(record.keyNum, this->keyBuffer);
+  this->scanResult.clear();
+  return this->concreteDB->scan(table, key, record.scanLength, ReadFields(record), this->scanResult);
+}
+
+template <typename W, typename K, typename D, bool R, bool U>
+inline Status BasicClient<W, K, D, R, U>::Update(const OperationRecord &record) {
+  const std::string &table = this->concreteWorkload->TableName(record.table);
+  std::string_view key = this->concreteWorkload->BuildKeyName(record.keyNum, this->keyBuffer);
+  uint64_t version = BuildWrite(record);
+  Status status = this->concreteDB->update(table, key, this->values);
+  RecordWrite(record, version, U, status);
+  return status;
+}
+
+template <typename W, typename K, typename D, bool R, bool U>
+inline Status BasicClient<W, K, D, R, U>::Insert(const OperationRecord &record) {
+  const std::string &table = this->concreteWorkload->TableName(record.table);
+  std::string_view key = this->concreteWorkload->BuildKeyName(record.keyNum, this->keyBuffer);
+  this->values.clear();
+  uint64_t version = this->concreteWorkload->W::BuildValues(record, this->values);
+  Status status = this->concreteDB->insert(table, key, this->values);
+  RecordWrite(record, version, true, status);
+  return status;
+}
+
+template <typename W, typename K, typename D, bool R, bool U>
+inline Status BasicClient<W, K, D, R, U>::Delete(const OperationRecord &record) {
+  const std::string &table = this->concreteWorkload->TableName(record.table);
+  std::string_view key = this->concreteWorkload->BuildKeyName(record.keyNum, this->keyBuffer);
+  return this->concreteDB->Delete(table, key);
+}
+
+///
+/// The BasicClient instantiation for KeyChooser and the workload's field modes.
+///
+template <typename KeyChooser>
+inline std::unique_ptr<Client> CreateClientFor(std::shared_ptr<DB> db, std::shared_ptr<CoreWorkload> wl) {
+  if (wl->read_all_fields()) {
+    if (wl->write_all_fields()) {
+      return std::unique_ptr<Client>(new BasicClient<CoreWorkload, KeyChooser, DB, true, true>(db, wl));
+    }
+    return std::unique_ptr<Client>(new BasicClient<CoreWorkload, KeyChooser, DB, true, false>(db, wl));
+  }
+  if (wl->write_all_fields()) {
+    return std::unique_ptr<Client>(new BasicClient<CoreWorkload, KeyChooser, DB, false, true>(db, wl));
+  }
+  return std::unique_ptr<Client>(new BasicClient<CoreWorkload, KeyChooser, DB, false, false>(db, wl));
+}
+
+///
+/// Name of the key chooser a specialized client exists for, e.g. "zipfian",
+/// or NULL if wl needs the generic Client.
+///
+inline const char *SpecializedKeyChooser(const CoreWorkload &wl) {
+  if (typeid(wl) != typeid(CoreWorkload)) {
+    return NULL;
+  }
+  if (wl.KeyChoosersAre<generators::UniformGenerator>()) {
+    return "uniform";
+  } else if (wl.KeyChoosersAre<generators::ScrambledZipfianGenerator>()) {
+    return "zipfian";
+  } else if (wl.KeyChoosersAre<generators::SkewedLatestGenerator>()) {
+    return "latest";
+  }
+  return NULL;
+}
+
+///
+/// Client of one thread: a BasicClient if the workload's configuration has
+/// one and specialized is set, the generic Client otherwise.
+///
+inline std::unique_ptr<Client> CreateClient(std::shared_ptr<DB> db, std::shared_ptr<CoreWorkload> wl,
+                                            bool specialized = true) {
+  if (specialized && typeid(*wl) == typeid(CoreWorkload)) {
+    if (wl->KeyChoosersAre<generators::UniformGenerator>()) {
+      return CreateClientFor<generators::UniformGenerator>(db, wl);
+    } else if (wl->KeyChoosersAre<generators::ScrambledZipfianGenerator>()) {
+      return CreateClientFor<generators::ScrambledZipfianGenerator>(db, wl);
+    } else if (wl->KeyChoosersAre<generators::SkewedLatestGenerator>()) {
+      return CreateClientFor<generators::SkewedLatestGenerator>(db, wl);
+    }
+  }
+  return std::unique_ptr<Client>(new Client(db, wl));
+}
+
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_BASICCLIENT_H_
@@ -29,13 +29,13 @@ public:
   }
   void cleanup() {};
 
-  Status read(const std::string &table, const std::string &key, 
-              const std::vector<std::string> &fields, std::vector<stringPair> &result) override {
+  Status read(const std::string &table, std::string_view key, 
+              FieldList fields, ReadResult &result) override {
     std::lock_guard<std::mutex> lock(mutex_);
     LOG(INFO) << "READ " << table << ' ' << key;
     if (!fields.empty()) {
       LOG(INFO) << " [ ";
-      for (auto f : fields) {
+      for (const std::string &f : fields) {
         LOG(INFO) << f << ' ';
       }
       LOG(INFO) << ']';
@@ -45,13 +45,13 @@ public:
     return Status::OK;
   }
 
-  Status scan(const std::string &table, const std::string &startkey, int recordcount, 
-              std::vector<std::string> &fields, std::vector<std::vector<stringPair>> &result) override {
+  Status scan(const std::string &table, std::string_view startkey, int recordcount, 
+              FieldList fields, ScanResult &result) override {
     std::lock_guard<std::mutex> lock(mutex_);
     LOG(INFO) << "SCAN " << table << ' ' << startkey << " " << recordcount;
     if (!fields.empty()) {
       LOG(INFO) << " [ ";
-      for (auto f : fields) {
+      for (const std::string &f : fields) {
         LOG(INFO) << f << ' ';
       }
       LOG(INFO) << ']';
@@ -61,29 +61,29 @@ public:
     return Status::OK;
   }
 
-  Status update(const std::string &table, const std::string &key, 
-                std::vector<stringPair> values) override {
+  Status update(const std::string &table, std::string_view key, 
+                RecordView values) override {
     std::lock_guard<std::mutex> lock(mutex_);
     LOG(INFO) << "UPDATE " << table << ' ' << key << " [ ";
-    for (auto v : values) {
-      LOG(INFO) << v.first << '=' << v.second << ' ';
+    for (const FieldValue &v : values) {
+      LOG(INFO) << v.field << '=' << v.value << ' ';
     }
     LOG(INFO) << ']';
     return Status::OK;
   }
 
-  Status insert(const std::string &table, const std::string &key, 
-                std::vector<stringPair> &values) override {
+  Status insert(const std::string &table, std::string_view key, 
+                RecordView values) override {
     std::lock_guard<std::mutex> lock(mutex_);
     LOG(INFO) << "INSERT " << table << ' ' << key << " [ ";
-    for (auto v : values) {
-      LOG(INFO) << v.first << '=' << v.second << ' ';
+    for (const FieldValue &v : values) {
+      LOG(INFO) << v.field << '=' << v.value << ' ';
     }
     LOG(INFO) << ']';
     return Status::OK;
   }
 
-  Status Delete(const std::string &table, const std::string &key) override {
+  Status Delete(const std::string &table, std::string_view key) override {
     std::lock_guard<std::mutex> lock(mutex_);
     LOG(INFO) << "DELETE " << table << ' ' << key;
     return Status::OK; 
@@ -3,6 +3,7 @@
 #ifndef _DBBENCHMARK_CLIENT_H_
 #define _DBBENCHMARK_CLIENT_H_
 
+#include <algorithm>
 #include <string>
 
 #include "DB.h"
@@ -19,46 +20,271 @@ class Client {
     Client(std::shared_ptr<DB> db, std::shared_ptr<CoreWorkload> wl) : db(db), workload(wl) { }
     
     virtual bool DoInsert();
+    /** Load the next count records through DB::batchInsert. A batch that reaches the
+    * next table of the load sequence is split at the table boundary.
+    * @param count Number of records to load.
+    * @return Number of records the database reported as inserted.
+    */
+    virtual int DoInsertBatch(std::size_t count);
     virtual bool DoTransaction();
+    /** Run count transactions back to back, or in windows of DB::pipelineDepth() when the
+    * database pipelines.
+    * @return Number of them the database reported as successful.
+    */
+    virtual int DoTransactions(int count);
+    /** Execute a transaction chosen up front, e.g. one replayed from an operation stream.
+    * @param record The operation and its parameters.
+    * @return true if the database reported success.
+    */
+    virtual bool DoOperation(const OperationRecord &record);
+    
+    /** Values this client's reads verified so far, see CoreWorkload::VerifyRead().
+    */
+    const utility::VerificationCounts &verification() const { return this->verificationCounts; }
     
     virtual ~Client() { }
     
   protected:
     
-    virtual Status TransactionRead();
-    virtual Status TransactionReadModifyWrite();
-    virtual Status TransactionScan();
-    virtual Status TransactionUpdate();
-    virtual Status TransactionInsert();
+    virtual Status TransactionRead(const OperationRecord &record);
+    virtual Status TransactionReadModifyWrite(const OperationRecord &record);
+    virtual Status TransactionScan(const OperationRecord &record);
+    virtual Status TransactionUpdate(const OperationRecord &record);
+    virtual Status TransactionInsert(const OperationRecord &record);
+    virtual Status TransactionDelete(const OperationRecord &record);
+    /// Send the batch built so far by DoInsertBatch() and clear it.
+    int FlushInsertBatch(std::size_t table);
+    /** Choose count transactions and hand them to DB::executeBatch() in one go, so a pipelining
+    * binding has them all in flight at once. Each transaction still counts, and is verified and
+    * acknowledged, by the status of its own operations.
+    * @return Number of transactions the database reported as successful.
+    */
+    int DoTransactionWindow(std::size_t count);
+    /// Check what a read returned and remember what a write stored, with dataintegrity.
+    void VerifyRead(const OperationRecord &record, const ReadResult &result,
+                    const Status &status);
+    void RecordWrite(const OperationRecord &record, uint64_t version, bool all_fields, const Status &status);
     
     std::shared_ptr<DB> db;
     std::shared_ptr<CoreWorkload> workload;
+    utility::KeyBuffer keyBuffer; /// Keys are formatted here, one operation at a time
+    // Scratch buffers of the client's thread. Each operation clears the ones it
+    // uses instead of building new vectors, so their capacity carries over and
+    // the steady state does not touch the heap. The read and scan results keep
+    // their cleared records and strings too, see ReusedVector.
+    std::vector<FieldValue> values;
+    ReadResult readResult;
+    ScanResult scanResult;
+    // Batched loads: one key buffer per record and the start of each record's
+    // fields in values. The views in batch are taken once values stops growing.
+    std::vector<utility::KeyBuffer> batchKeys;
+    std::vector<std::size_t> batchOffsets;
+    std::vector<KeyedRecord> batch;
+    // Transaction windows: the records chosen, the operations sent for them and
+    // a result buffer per record. Keys and values reuse batchKeys, values and
+    // batchOffsets, which here hold the start of each operation's fields.
+    std::vector<OperationRecord> windowRecords;
+    std::vector<uint64_t> windowVersions;
+    std::vector<DBOperation> windowOperations;
+    std::vector<ReadResult> windowReads;
+    std::vector<ScanResult> windowScans;
+    utility::WriteVersionCache writtenVersions; /// Versions of this client's latest writes
+    utility::VerificationCounts verificationCounts;
 };
 
 inline bool Client::DoInsert() {
-  std::string key = this->workload->NextSequenceKey();
-  std::vector<stringPair> pairs;
-  this->workload->BuildValues(pairs);
-  return (this->db->insert(this->workload->NextTable(), key, pairs) == Status::OK);
+  std::size_t table;
+  uint64_t key_num = this->workload->NextSequenceKeyNum(table);
+  std::string_view key = this->workload->BuildKeyName(key_num, this->keyBuffer);
+  this->values.clear();
+  this->workload->BuildValues(this->values, table, key_num);
+  return (this->db->insert(this->workload->TableName(table), key, this->values) == Status::OK);
+}
+
+inline int Client::DoInsertBatch(std::size_t count) {
+  if (this->batchKeys.size() < count) {
+    this->batchKeys.resize(count);
+  }
+  this->values.clear();
+  this->batchOffsets.clear();
+  int oks = 0;
+  std::size_t batch_table = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    std::size_t table;
+    uint64_t key_num = this->workload->NextSequenceKeyNum(table);
+    if (!this->batchOffsets.empty() && table != batch_table) {
+      oks += FlushInsertBatch(batch_table);
+    }
+    batch_table = table;
+    this->workload->BuildKeyName(key_num, this->batchKeys[this->batchOffsets.size()]);
+    this->batchOffsets.push_back(this->values.size());
+    this->workload->BuildValues(this->values, table, key_num);
+  }
+  return oks + FlushInsertBatch(batch_table);
+}
+
+inline int Client::FlushInsertBatch(std::size_t table) {
+  const std::size_t count = this->batchOffsets.size();
+  if (count == 0) {
+    return 0;
+  }
+  this->batch.clear();
+  for (std::size_t i = 0; i < count; ++i) {
+    std::size_t end = (i + 1 < count ? this->batchOffsets[i + 1] : this->values.size());
+    this->batch.push_back({this->batchKeys[i].view(),
+        RecordView(this->values.data() + this->batchOffsets[i], end - this->batchOffsets[i])});
+  }
+  Status status = this->db->batchInsert(this->workload->TableName(table), this->batch);
+  this->values.clear();
+  this->batchOffsets.clear();
+  return (status == Status::OK ? static_cast<int>(count) : 0);
 }
 
 inline bool Client::DoTransaction() {
+  OperationRecord record;
+  this->workload->NextOperationRecord(record);
+  bool isOk = DoOperation(record);
+  if (record.operation == INSERT) {
+    // Acknowledge even on failure, otherwise the limit would stall here.
+    this->workload->AcknowledgeInsert(record.keyNum, record.table);
+  }
+  return isOk;
+}
+
+inline int Client::DoTransactions(int count) {
+  const int window = static_cast<int>(this->db->pipelineDepth());
+  int oks = 0;
+  if (window > 1) {
+    for (int i = 0; i < count; i += window) {
+      oks += DoTransactionWindow(std::min(window, count - i));
+    }
+    return oks;
+  }
+  for (int i = 0; i < count; ++i) {
+    oks += DoTransaction();
+  }
+  return oks;
+}
+
+inline int Client::DoTransactionWindow(std::size_t count) {
+  if (this->batchKeys.size() < count) {
+    this->batchKeys.resize(count);
+  }
+  if (this->windowReads.size() < count) {
+    this->windowReads.resize(count);
+    this->windowScans.resize(count);
+  }
+  this->windowRecords.resize(count);
+  this->windowVersions.assign(count, 0);
+  this->windowOperations.clear();
+  this->batchOffsets.clear();
+  this->values.clear();
+  for (std::size_t i = 0; i < count; ++i) {
+    OperationRecord &record = this->windowRecords[i];
+    this->workload->NextOperationRecord(record);
+    DBOperation operation;
+    operation.table = &this->workload->TableName(record.table);
+    operation.key = this->workload->BuildKeyName(record.keyNum, this->batchKeys[i]);
+    if (!this->workload->read_all_fields()) {
+      operation.fields = this->workload->SingleField(record.fieldId, record.table);
+    }
+    if (record.operation == READ || record.operation == READMODIFYWRITE) {
+      this->windowReads[i].clear();
+      operation.type = DBOperation::READ;
+      operation.result = &this->windowReads[i];
+      this->batchOffsets.push_back(this->values.size());
+      this->windowOperations.push_back(operation);
+    }
+    switch (record.operation) {
+      case READ:
+        continue;
+      case SCAN:
+        this->windowScans[i].clear();
+        operation.type = DBOperation::SCAN;
+        operation.recordCount = record.scanLength;
+        operation.scanResult = &this->windowScans[i];
+        break;
+      case UPDATE:
+      case READMODIFYWRITE:
+        operation.type = DBOperation::UPDATE;
+        this->batchOffsets.push_back(this->values.size());
+        if (this->workload->write_all_fields()) {
+          this->windowVersions[i] = this->workload->BuildValues(record, this->values);
+        } else {
+          this->windowVersions[i] = this->workload->BuildUpdate(record, this->values);
+        }
+        this->windowOperations.push_back(operation);
+        continue;
+      case INSERT:
+        operation.type = DBOperation::INSERT;
+        this->batchOffsets.push_back(this->values.size());
+        this->windowVersions[i] = this->workload->BuildValues(record, this->values);
+        this->windowOperations.push_back(operation);
+        continue;
+      case DELETE:
+        operation.type = DBOperation::DELETE;
+        break;
+      default:
+        throw NotImplementedException("Operation request is not recognized!");
+    }
+    this->batchOffsets.push_back(this->values.size());
+    this->windowOperations.push_back(operation);
+  }
+  // values has stopped growing, so the views of the written fields can be taken.
+  for (std::size_t j = 0; j < this->windowOperations.size(); ++j) {
+    std::size_t end = (j + 1 < this->batchOffsets.size() ? this->batchOffsets[j + 1] : this->values.size());
+    this->windowOperations[j].values = RecordView(this->values.data() + this->batchOffsets[j],
+                                                  end - this->batchOffsets[j]);
+  }
+  this->db->executeBatch(this->windowOperations);
+
+  int oks = 0;
+  std::size_t j = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    const OperationRecord &record = this->windowRecords[i];
+    if (record.operation == READ || record.operation == READMODIFYWRITE) {
+      VerifyRead(record, this->windowReads[i], this->windowOperations[j].status);
+      if (record.operation == READ) {
+        oks += (this->windowOperations[j++].status == Status::OK);
+        continue;
+      }
+      ++j;
+    }
+    const Status &status = this->windowOperations[j++].status;
+    if (record.operation == UPDATE || record.operation == READMODIFYWRITE) {
+      RecordWrite(record, this->windowVersions[i], this->workload->write_all_fields(), status);
+    } else if (record.operation == INSERT) {
+      RecordWrite(record, this->windowVersions[i], true, status);
+      // Acknowledge even on failure, otherwise the limit would stall here.
+      this->workload->AcknowledgeInsert(record.keyNum, record.table);
+    }
+    oks += (status == Status::OK);
+  }
+  this->values.clear();
+  this->batchOffsets.clear();
+  return oks;
+}
+
+inline bool Client::DoOperation(const OperationRecord &record) {
   Status tmpStatus;
-  switch (this->workload->NextOperation()) {
+  switch (record.operation) {
     case READ:
-      tmpStatus = TransactionRead();
+      tmpStatus = TransactionRead(record);
       break;
     case UPDATE:
-      tmpStatus = TransactionUpdate();
+      tmpStatus = TransactionUpdate(record);
       break;
     case INSERT:
-      tmpStatus = TransactionInsert();
+      tmpStatus = TransactionInsert(record);
       break;
     case SCAN:
-      tmpStatus = TransactionScan();
+      tmpStatus = TransactionScan(record);
       break;
     case READMODIFYWRITE:
-      tmpStatus = TransactionReadModifyWrite();
+      tmpStatus = TransactionReadModifyWrite(record);
+      break;
+    case DELETE:
+      tmpStatus = TransactionDelete(record);
       break;
     default:
       throw NotImplementedException("Operation request is not recognized!");
@@ -66,73 +292,97 @@ inline bool Client::DoTransaction() {
   return (tmpStatus == Status::OK);
 }
 
-inline Status Client::TransactionRead() {
-  const std::string &table = this->workload->NextTable();
-  const std::string &key = this->workload->NextTransactionKey();
-  std::vector<stringPair> result;
-  std::vector<std::string> fields;
+inline void Client::VerifyRead(const OperationRecord &record, const ReadResult &result,
+                               const Status &status) {
+  if (this->workload->data_integrity() && status == Status::OK) {
+    this->workload->VerifyRead(record, result, this->writtenVersions, this->verificationCounts);
+  }
+}
+
+inline void Client::RecordWrite(const OperationRecord &record, uint64_t version, bool all_fields,
+                                const Status &status) {
+  if (this->workload->data_integrity() && status == Status::OK) {
+    this->writtenVersions.Record(record.table, record.keyNum,
+        all_fields ? utility::WriteVersionCache::kAllFields : record.fieldId, version);
+  }
+}
+
+inline Status Client::TransactionRead(const OperationRecord &record) {
+  const std::string &table = this->workload->TableName(record.table);
+  std::string_view key = this->workload->BuildKeyName(record.keyNum, this->keyBuffer);
+  this->readResult.clear();
+  FieldList fields;
   if (!this->workload->read_all_fields()) {
-    fields.push_back("field" + this->workload->NextFieldName());
-    return this->db->read(table, key, fields, result);
-  } else {
-    return this->db->read(table, key, fields, result);
+    fields = this->workload->SingleField(record.fieldId, record.table);
   }
+  Status status = this->db->read(table, key, fields, this->readResult);
+  VerifyRead(record, this->readResult, status);
+  return status;
 }
 
-inline Status Client::TransactionReadModifyWrite() {
-  const std::string &table = this->workload->NextTable();
-  const std::string &key = this->workload->NextTransactionKey();
-  std::vector<stringPair> result;
-  std::vector<std::string> fields;
+inline Status Client::TransactionReadModifyWrite(const OperationRecord &record) {
+  const std::string &table = this->workload->TableName(record.table);
+  std::string_view key = this->workload->BuildKeyName(record.keyNum, this->keyBuffer);
+  this->readResult.clear();
+  FieldList fields;
   if (!this->workload->read_all_fields()) {
-    
-    fields.push_back("field" + this->workload->NextFieldName());
-    this->db->read(table, key, fields, result);
-  } else {
-    this->db->read(table, key, fields, result);
+    fields = this->workload->SingleField(record.fieldId, record.table);
   }
+  VerifyRead(record, this->readResult, this->db->read(table, key, fields, this->readResult));
 
-  std::vector<stringPair> values;
+  this->values.clear();
+  uint64_t version;
   if (this->workload->write_all_fields()) {
-    this->workload->BuildValues(values);
+    version = this->workload->BuildValues(record, this->values);
   } else {
-    this->workload->BuildUpdate(values);
+    version = this->workload->BuildUpdate(record, this->values);
   }
-  return this->db->update(table, key, values);
+  Status status = this->db->update(table, key, this->values);
+  RecordWrite(record, version, this->workload->write_all_fields(), status);
+  return status;
 }
 
-inline Status Client::TransactionScan() {
-  const std::string &table = this->workload->NextTable();
-  const std::string &key = this->workload->NextTransactionKey();
-  int len = this->workload->NextScanLength();
-  std::vector<std::vector<stringPair>> result;
-  std::vector<std::string> fields;
+inline Status Client::TransactionScan(const OperationRecord &record) {
+  const std::string &table = this->workload->TableName(record.table);
+  std::string_view key = this->workload->BuildKeyName(record.keyNum, this->keyBuffer);
+  int len = record.scanLength;
+  this->scanResult.clear();
+  FieldList fields;
   if (!this->workload->read_all_fields()) {
-    fields.push_back("field" + this->workload->NextFieldName());
-    return this->db->scan(table, key, len, fields, result);
-  } else {
-    return this->db->scan(table, key, len, fields, result);
+    fields = this->workload->SingleField(record.fieldId, record.table);
   }
+  return this->db->scan(table, key, len, fields, this->scanResult);
 }
 
-inline Status Client::TransactionUpdate() {
-  const std::string &table = this->workload->NextTable();
-  const std::string &key = this->workload->NextTransactionKey();
-  std::vector<stringPair> values;
+inline Status Client::TransactionUpdate(const OperationRecord &record) {
+  const std::string &table = this->workload->TableName(record.table);
+  std::string_view key = this->workload->BuildKeyName(record.keyNum, this->keyBuffer);
+  this->values.clear();
+  uint64_t version;
   if (this->workload->write_all_fields()) {
-    this->workload->BuildValues(values);
+    version = this->workload->BuildValues(record, this->values);
   } else {
-    this->workload->BuildUpdate(values);
+    version = this->workload->BuildUpdate(record, this->values);
   }
-  return this->db->update(table, key, values);
+  Status status = this->db->update(table, key, this->values);
+  RecordWrite(record, version, this->workload->write_all_fields(), status);
+  return status;
+}
+
+inline Status Client::TransactionDelete(const OperationRecord &record) {
+  const std::string &table = this->workload->TableName(record.table);
+  std::string_view key = this->workload->BuildKeyName(record.keyNum, this->keyBuffer);
+  return this->db->Delete(table, key);
 }
 
-inline Status Client::TransactionInsert() {
-  const std::string &table = this->workload->NextTable();
-  const std::string &key = this->workload->NextSequenceKey();
-  std::vector<stringPair> values;
-  this->workload->BuildValues(values);
-  return this->db->insert(table, key, values);
+inline Status Client::TransactionInsert(const OperationRecord &record) {
+  const std::string &table = this->workload->TableName(record.table);
+  std::string_view key = this->workload->BuildKeyName(record.keyNum, this->keyBuffer);
+  this->values.clear();
+  uint64_t version = this->workload->BuildValues(record, this->values);
+  Status status = this->db->insert(table, key, this->values);
+  RecordWrite(record, version, true, status);
+  return status;
 }
 
 } // namespace dbtester
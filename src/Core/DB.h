@@ -3,23 +3,48 @@
 #ifndef _DBBENCHMARK_DB_H_
 #define _DBBENCHMARK_DB_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <iterator>
+#include <vector>
 
 #include "Core/Utility/ProgramConfigurations/LayeredConfiguration.h"
 #include "Core/Utility/LoggerSink.hpp"
 #include "Core/Utility/Utils.h"
+#include "Record.h"
 #include "Status.h"
 
 using namespace dbbenchmark::utility;
 
 namespace dbbenchmark {
+///
+/// One operation of DB::executeBatch(): the arguments of the matching single
+/// call, where its results go and, once executed, its status. A read-modify-
+/// write is a READ followed by an UPDATE of the same key.
+///
+struct DBOperation {
+    enum Type : uint8_t { READ, SCAN, UPDATE, INSERT, DELETE };
+
+    Type type = READ;
+    const std::string *table = nullptr;
+    std::string_view key;
+    FieldList fields;        /// READ and SCAN
+    int recordCount = 0;     /// SCAN
+    RecordView values;       /// UPDATE and INSERT
+    ReadResult *result = nullptr;      /// READ
+    ScanResult *scanResult = nullptr;  /// SCAN
+    Status status;
+};
+
 /**
 *   \brief Interface for database objects.
 *   \details  Database accessing layer. Each thread in the client will be given its own instance of whatever DB 
 *     class is to be used in the test. This class should be constructed using a no-argument 
 *     constructor, so we can load it dynamically. Any argument-based initialization 
 *     should be done by init().
+*     Keys are passed as views that are valid only during the call. They are always followed by a NUL byte,
+*     so key.data() can be handed to client libraries that expect C strings.
 *   \author Ozgun AY
 *   \version 1.0
 *   \date 21/11/2018
@@ -37,11 +62,12 @@ public:
     * @param table The name of the table
     * @param key The record key of the record to read.
     * @param fields The list of fields to read, or null for all of them
-    * @param result A vector of field/value pairs for the result
+    * @param result Field/value pairs for the result. Fill it with emplace_back(), which reuses
+    *   the strings of earlier results.
     * @return The result of the operation.
     */
-    virtual Status read(const std::string &table, const std::string &key, 
-                        const std::vector<std::string> &fields, std::vector<stringPair> &result) = 0;
+    virtual Status read(const std::string &table, std::string_view key, 
+                        FieldList fields, ReadResult &result) = 0;
     /** Perform a range scan for a set of records in the database. Each field/value pair from the result will be stored
     * in a list.
     *
@@ -49,35 +75,98 @@ public:
     * @param startkey The record key of the first record to read.
     * @param recordcount The number of records to read
     * @param fields The list of fields to read, or null for all of them
-    * @param result A Vector of results, where each HashMap is a set field/value pairs for one record
+    * @param result A record of field/value pairs per record scanned, filled as for read()
     * @return The result of the operation.
     */
-    virtual Status scan(const std::string &table, const std::string &startkey, int recordcount, 
-                        std::vector<std::string> &fields, std::vector<std::vector<stringPair>> &result) = 0;
+    virtual Status scan(const std::string &table, std::string_view startkey, int recordcount, 
+                        FieldList fields, ScanResult &result) = 0;
     /** Update a record in the database. Any field/value pairs in the specified values will be written into the
     * record with the specified record key, overwriting any existing values with the same field name.
     * @param table The name of the table
     * @param key The record key of the record to write.
-    * @param values A HashMap of field/value pairs to update in the record
+    * @param values The field/value pairs to update in the record. Views, valid only during the call.
     * @return The result of the operation.
     */
-    virtual Status update(const std::string &table, const std::string &key, 
-                        std::vector<stringPair> values) = 0;
+    virtual Status update(const std::string &table, std::string_view key, 
+                        RecordView values) = 0;
     /** Insert a record in the database. Any field/value pairs in the specified values will be written into the
     * record with the specified record key.
     * @param table The name of the table
     * @param key The record key of the record to insert.
-    * @param values A HashMap of field/value pairs to insert in the record
+    * @param values The field/value pairs to insert in the record. Views, valid only during the call.
     * @return The result of the operation.
     */
-    virtual Status insert(const std::string &table, const std::string &key, 
-                        std::vector<stringPair> &values) = 0;
+    virtual Status insert(const std::string &table, std::string_view key, 
+                        RecordView values) = 0;
     /** Delete a record from the database.
     * @param table The name of the table
     * @param key The record key of the record to delete.
     * @return The result of the operation.
     */
-    virtual Status Delete(const std::string &table, const std::string &startkey) = 0;
+    virtual Status Delete(const std::string &table, std::string_view startkey) = 0;
+    /** Insert several records of one table. Bindings with a native bulk write (pipelines,
+    * multi-document inserts, batches) override this; the default inserts one record at a time.
+    * @param table The name of the table
+    * @param records The records to insert. Views, valid only during the call.
+    * @return OK if every record was inserted, otherwise the last error.
+    */
+    virtual Status batchInsert(const std::string &table, const std::vector<KeyedRecord> &records) {
+        Status status = Status::OK;
+        for (const KeyedRecord &record : records) {
+            Status recordStatus = insert(table, record.key, record.values);
+            if (!(recordStatus == Status::OK)) {
+                status = recordStatus;
+            }
+        }
+        return status;
+    }
+    /** Update several records of one table, see batchInsert().
+    * @param table The name of the table
+    * @param records The records to update. Views, valid only during the call.
+    * @return OK if every record was updated, otherwise the last error.
+    */
+    virtual Status batchUpdate(const std::string &table, const std::vector<KeyedRecord> &records) {
+        Status status = Status::OK;
+        for (const KeyedRecord &record : records) {
+            Status recordStatus = update(table, record.key, record.values);
+            if (!(recordStatus == Status::OK)) {
+                status = recordStatus;
+            }
+        }
+        return status;
+    }
+
+    /** Number of operations the binding can have in flight on its connection, e.g. the depth of a
+    * pipeline. Above 1, clients hand transactions to executeBatch() that many at a time and batched
+    * loads are at least that large.
+    */
+    virtual std::size_t pipelineDepth() const { return 1; }
+    /** Execute operations in order and set the status of each. Bindings that pipeline override this
+    * to send them without waiting for each reply; the default executes them one at a time.
+    * @param operations The operations, with views valid only during the call.
+    */
+    virtual void executeBatch(std::vector<DBOperation> &operations) {
+        for (DBOperation &operation : operations) {
+            switch (operation.type) {
+                case DBOperation::READ:
+                    operation.status = read(*operation.table, operation.key, operation.fields, *operation.result);
+                    break;
+                case DBOperation::SCAN:
+                    operation.status = scan(*operation.table, operation.key, operation.recordCount,
+                                            operation.fields, *operation.scanResult);
+                    break;
+                case DBOperation::UPDATE:
+                    operation.status = update(*operation.table, operation.key, operation.values);
+                    break;
+                case DBOperation::INSERT:
+                    operation.status = insert(*operation.table, operation.key, operation.values);
+                    break;
+                case DBOperation::DELETE:
+                    operation.status = Delete(*operation.table, operation.key);
+                    break;
+            }
+        }
+    }
 
 protected:
     utility::programconfigurations::LayeredConfiguration* m_localConf;   // Properties of DB.
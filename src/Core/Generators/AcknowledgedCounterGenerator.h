@@ -0,0 +1,99 @@
+// AcknowledgedCounterGenerator.h
+
+#ifndef _DBBENCHMARK_ACKNOWLEDGEDCOUNTERGENERATOR_H_
+#define _DBBENCHMARK_ACKNOWLEDGEDCOUNTERGENERATOR_H_
+
+#include "CounterGenerator.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "Core/Utility/Exception.h"
+
+namespace dbbenchmark {
+namespace generators {
+/**
+* \brief A CounterGenerator that reports generated integers via Last() only after they have been acknowledged.
+* \details Next() hands out values like CounterGenerator; Acknowledge() marks a value as done (e.g. its insert
+*     has completed). Last() returns the highest value below which every value has been acknowledged, so readers
+*     following it never pick a key whose insert is still in flight.
+*     Acknowledgements are recorded in a fixed sliding window of flags. Whoever wins a try-lock slides the limit
+*     forward over contiguous acknowledged slots; everybody else just sets its flag and returns, so no thread
+*     ever blocks in Acknowledge().
+* \author Ozgun AY
+* \version 1.0
+* \date 21/11/2018
+* \bug None so far
+*/
+class AcknowledgedCounterGenerator : public CounterGenerator {
+public:
+  /// Number of values that may be outstanding (handed out but not acknowledged) at once.
+  static const uint64_t kWindowSize = (1 << 20);
+
+  /** Create a counter that starts at start.
+  * @param start First value handed out by Next().
+  */
+  explicit AcknowledgedCounterGenerator(uint64_t start) :
+      CounterGenerator(start), window(new std::atomic<bool>[kWindowSize]), limit(start - 1) {
+    for (uint64_t i = 0; i < kWindowSize; ++i) {
+      this->window[i].store(false, std::memory_order_relaxed);
+    }
+    this->advancing.clear();
+  }
+  /** In contrast to the base class, Last() returns the largest value such that every value up to and
+  * including it has been acknowledged.
+  */
+  uint64_t Last() override { return this->limit.load(std::memory_order_acquire); }
+  /** Set a start point. Must not be called while values are outstanding.
+  * @param start Start point for counter.
+  */
+  void Set(uint64_t start) {
+    CounterGenerator::Set(start);
+    this->limit.store(start - 1, std::memory_order_release);
+  }
+  /** Make a generated value available via Last().
+  * @param value A value previously returned by Next().
+  */
+  void Acknowledge(uint64_t value);
+
+private:
+  static const uint64_t kWindowMask = kWindowSize - 1;
+
+  std::unique_ptr<std::atomic<bool>[]> window;
+  std::atomic<uint64_t> limit;
+  std::atomic_flag advancing;
+};
+
+inline void AcknowledgedCounterGenerator::Acknowledge(uint64_t value) {
+  if (value - this->limit.load(std::memory_order_acquire) > kWindowSize) {
+    throw utility::IllegalStateException("Too many unacknowledged insertion keys.");
+  }
+  this->window[value & kWindowMask].store(true, std::memory_order_release);
+
+  // A thread that loses the try-lock relies on the winner to pick its flag up,
+  // so the winner re-checks the next slot after unlocking. Each side writes one
+  // location and then reads the other's, so both need a full fence: otherwise
+  // the loser can miss the clear while the winner misses the flag, and the limit
+  // stalls until the next acknowledgement.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  do {
+    if (this->advancing.test_and_set(std::memory_order_acquire)) {
+      return;
+    }
+    uint64_t index = this->limit.load(std::memory_order_relaxed) + 1;
+    while (this->window[index & kWindowMask].load(std::memory_order_acquire)) {
+      this->window[index & kWindowMask].store(false, std::memory_order_relaxed);
+      ++index;
+    }
+    this->limit.store(index - 1, std::memory_order_release);
+    this->advancing.clear(std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  } while (this->window[(this->limit.load(std::memory_order_acquire) + 1) & kWindowMask]
+               .load(std::memory_order_acquire));
+}
+
+} // namespace generators
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_ACKNOWLEDGEDCOUNTERGENERATOR_H_
@@ -8,6 +8,8 @@
 #include <cstdint>
 #include <atomic>
 
+#include "Core/Utility/VectorKernels.h"
+
 namespace dbbenchmark {
 namespace generators {
 /**
@@ -23,6 +25,11 @@ public:
   explicit CounterGenerator(uint64_t start) : counterValue(start) { }
   uint64_t Next() override { return this->counterValue.fetch_add(1); }
   uint64_t Last() override { return this->counterValue.load() - 1; }
+  /** Reserve n consecutive values with a single atomic add.
+  */
+  void NextBatch(uint64_t *out, std::size_t n) override {
+    utility::FillSequence(out, n, this->counterValue.fetch_add(n));
+  }
   /** Set a start point.
   * @param start Start point for counter.
   */
@@ -0,0 +1,124 @@
+// DriftingGenerator.h
+
+#ifndef _DBBENCHMARK_DRIFTINGGENERATOR_H_
+#define _DBBENCHMARK_DRIFTINGGENERATOR_H_
+
+#include "Generator.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "Core/Utility/Exception.h"
+
+namespace dbbenchmark {
+namespace generators {
+/**
+*   \brief A generator whose hot set moves through the keyspace as the run progresses.
+*   \details Wraps a skewed generator over [min, max] (e.g. zipfian or hotspot) and rotates its
+*       output by an offset that grows with the number of values drawn: distance keys every interval
+*       draws. In STEP mode the hot set jumps by distance at each interval boundary, which shows how
+*       long caches take to recover from a sudden shift; in CONTINUOUS mode it slides by one key at a
+*       time at the same average rate. The offset depends only on the draw count, not on wall clock
+*       time, so a drifting run is reproducible and can be recorded into an operation stream.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class DriftingGenerator : public Generator<uint64_t> {
+public:
+  enum Mode {
+    STEP,
+    CONTINUOUS
+  };
+
+  /**
+  * Create a drifting generator.
+  * @param generator The wrapped generator, producing values in [min, max]. Ownership is taken.
+  * @param min The smallest integer of the keyspace.
+  * @param max The largest integer of the keyspace.
+  * @param interval Number of draws over which the hot set moves by distance keys.
+  * @param distance Number of keys the hot set moves per interval.
+  * @param mode STEP or CONTINUOUS.
+  */
+  DriftingGenerator(Generator<uint64_t> *generator, uint64_t min, uint64_t max,
+                    uint64_t interval, uint64_t distance, Mode mode);
+
+  uint64_t Next() override;
+  uint64_t Last() override;
+  /**
+  * Draw a batch from the wrapped generator and rotate each value by the offset
+  * of its own position in the draw sequence.
+  */
+  void NextBatch(uint64_t *out, std::size_t n) override;
+  /** Offset applied to the draw with the given sequence number.
+  */
+  uint64_t Offset(uint64_t draw) const;
+
+private:
+  uint64_t Rotate(uint64_t value, uint64_t draw) const {
+    return this->base + (value - this->base + Offset(draw)) % this->numItems;
+  }
+
+  std::unique_ptr<Generator<uint64_t>> generator;
+  const uint64_t base;
+  const uint64_t numItems;
+  const uint64_t interval;
+  uint64_t distance;
+  const Mode mode;
+  std::atomic<uint64_t> draws;
+  std::atomic<uint64_t> lastValue;
+};
+
+inline DriftingGenerator::DriftingGenerator(Generator<uint64_t> *generator, uint64_t min, uint64_t max,
+                                            uint64_t interval, uint64_t distance, Mode mode) :
+    generator(generator), base(min), numItems(max - min + 1), interval(interval),
+    distance(distance), mode(mode), draws(0), lastValue(min) {
+  if (generator == nullptr || min > max) {
+    throw utility::InvalidArgumentException("Drifting generator needs a generator over [min, max]");
+  }
+  if (interval == 0) {
+    throw utility::InvalidArgumentException("Drift interval must be positive");
+  }
+  this->distance %= this->numItems;
+}
+
+inline uint64_t DriftingGenerator::Offset(uint64_t draw) const {
+  uint64_t steps = draw / this->interval;
+  // Reducing steps first keeps the product in range for long runs.
+  uint64_t offset = (steps % this->numItems) * this->distance % this->numItems;
+  if (this->mode == CONTINUOUS) {
+    uint64_t partial = draw % this->interval;
+    offset += static_cast<uint64_t>(static_cast<double>(partial) * this->distance / this->interval);
+  }
+  return offset % this->numItems;
+}
+
+inline uint64_t DriftingGenerator::Next() {
+  uint64_t draw = this->draws.fetch_add(1, std::memory_order_relaxed);
+  uint64_t value = Rotate(this->generator->Next(), draw);
+  this->lastValue.store(value, std::memory_order_relaxed);
+  return value;
+}
+
+inline void DriftingGenerator::NextBatch(uint64_t *out, std::size_t n) {
+  if (n == 0) {
+    return;
+  }
+  uint64_t draw = this->draws.fetch_add(n, std::memory_order_relaxed);
+  this->generator->NextBatch(out, n);
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i] = Rotate(out[i], draw + i);
+  }
+  this->lastValue.store(out[n - 1], std::memory_order_relaxed);
+}
+
+inline uint64_t DriftingGenerator::Last() {
+  return this->lastValue.load(std::memory_order_relaxed);
+}
+
+} // namespace generators
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_DRIFTINGGENERATOR_H_
@@ -0,0 +1,203 @@
+// EmpiricalGenerator.h
+
+#ifndef _DBBENCHMARK_EMPIRICALGENERATOR_H_
+#define _DBBENCHMARK_EMPIRICALGENERATOR_H_
+
+#include "Generator.h"
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Core/Utility/Exception.h"
+#include "Core/Utility/MappedFile.h"
+
+namespace dbbenchmark {
+namespace generators {
+/**
+*   \brief A generator that replays a measured key-popularity distribution.
+*   \details The distribution is read from a binary histogram file, typically exported from production
+*       access logs, and sampled in O(1) with Walker/Vose alias tables. The file is memory mapped; key ids
+*       are read straight from the mapping and only the alias tables (8 bytes per entry) live on the heap.
+*
+*       File layout (host byte order):
+*       <pre>
+*         offset  0: char     magic[8]   "DBBHIST1"
+*         offset  8: uint32_t kind       0 = histogram (weights are access counts or frequencies)
+*                                        1 = CDF (weights are cumulative and non-decreasing)
+*         offset 12: uint32_t reserved   0
+*         offset 16: uint64_t count      number of entries, at most 2^32 - 1
+*         offset 24: count x { uint64_t key; double weight; }
+*       </pre>
+*       Keys are record numbers as used by CoreWorkload, i.e. before insertorder hashing.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class EmpiricalGenerator : public Generator<uint64_t> {
+public:
+  enum Kind : uint32_t {
+    HISTOGRAM = 0,
+    CDF = 1
+  };
+
+  struct Entry {
+    uint64_t key;
+    double weight;
+  };
+
+  struct Header {
+    char magic[8];
+    uint32_t kind;
+    uint32_t reserved;
+    uint64_t count;
+  };
+
+  /** Load a histogram file and build the alias tables.
+  * @param filePath Path of the histogram file.
+  * @throw FileException if the file cannot be mapped, DataException if it is malformed.
+  */
+  explicit EmpiricalGenerator(const std::string &filePath);
+
+  uint64_t Next() override;
+  uint64_t Last() override;
+  /**
+  * Generate n values while holding the lock once.
+  */
+  void NextBatch(uint64_t *out, std::size_t n) override;
+
+  std::size_t size() const { return this->numEntries; }
+
+private:
+  void BuildAliasTables();
+  /**
+  * One 64-bit draw gives both the column (low half, Lemire's multiply-shift)
+  * and the coin flip against the column threshold (high half).
+  */
+  uint64_t NextLocked() {
+    uint64_t r = this->generator();
+    uint64_t column = ((r & 0xFFFFFFFFULL) * this->numEntries) >> 32;
+    uint32_t coin = static_cast<uint32_t>(r >> 32);
+    uint64_t index = (coin < this->threshold[column]) ? column : this->alias[column];
+    return this->entries[index].key;
+  }
+
+  utility::MappedFile file;
+  const Entry *entries;
+  uint64_t numEntries;
+  Kind kind;
+  std::vector<uint32_t> threshold; /// Probability of keeping the column, scaled to 2^32
+  std::vector<uint32_t> alias;     /// Entry taken when the coin flip fails
+  uint64_t lastValue;
+  std::mt19937_64 generator;
+  std::mutex mutex;
+};
+
+inline EmpiricalGenerator::EmpiricalGenerator(const std::string &filePath) :
+    file(filePath), entries(nullptr), numEntries(0), kind(HISTOGRAM) {
+  if (this->file.size() < sizeof(Header)) {
+    throw utility::DataException("Histogram file is too short: " + filePath);
+  }
+  Header header;
+  std::memcpy(&header, this->file.data(), sizeof(Header));
+  if (std::memcmp(header.magic, "DBBHIST1", sizeof(header.magic)) != 0) {
+    throw utility::DataException("Not a histogram file: " + filePath);
+  }
+  if (header.kind != HISTOGRAM && header.kind != CDF) {
+    throw utility::DataException("Unknown histogram kind in " + filePath);
+  }
+  if (header.count == 0 || header.count > UINT32_MAX ||
+      (this->file.size() - sizeof(Header)) / sizeof(Entry) < header.count) {
+    throw utility::DataException("Bad histogram entry count in " + filePath);
+  }
+  this->kind = static_cast<Kind>(header.kind);
+  this->numEntries = header.count;
+  this->entries = reinterpret_cast<const Entry *>(this->file.data() + sizeof(Header));
+  BuildAliasTables();
+  Next();
+}
+
+/**
+* Vose's alias method. Weights are normalized so their mean is 1; columns
+* below 1 ("small") are topped up by a column above 1 ("large").
+*/
+inline void EmpiricalGenerator::BuildAliasTables() {
+  const uint64_t n = this->numEntries;
+  std::vector<double> scaled(n);
+  double total = 0.0;
+  double previous = 0.0;
+  for (uint64_t i = 0; i < n; ++i) {
+    double weight = this->entries[i].weight;
+    if (this->kind == CDF) {
+      if (weight < previous) {
+        throw utility::DataException("CDF weights must be non-decreasing");
+      }
+      double cumulative = weight;
+      weight -= previous;
+      previous = cumulative;
+    }
+    if (!(weight >= 0.0)) {
+      throw utility::DataException("Histogram weights must be non-negative");
+    }
+    scaled[i] = weight;
+    total += weight;
+  }
+  if (!(total > 0.0)) {
+    throw utility::DataException("Histogram has no weight");
+  }
+
+  std::vector<uint32_t> small;
+  std::vector<uint32_t> large;
+  for (uint64_t i = 0; i < n; ++i) {
+    scaled[i] = scaled[i] * n / total;
+    (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+  }
+
+  const double kScale = 4294967296.0; // 2^32
+  this->threshold.assign(n, UINT32_MAX);
+  this->alias.resize(n);
+  for (uint64_t i = 0; i < n; ++i) {
+    this->alias[i] = static_cast<uint32_t>(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    uint32_t less = small.back();
+    small.pop_back();
+    uint32_t more = large.back();
+    large.pop_back();
+    this->threshold[less] = static_cast<uint32_t>(scaled[less] * kScale);
+    this->alias[less] = more;
+    scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+    (scaled[more] < 1.0 ? small : large).push_back(more);
+  }
+  // Whatever is left is 1 up to rounding error and always keeps its column.
+}
+
+inline uint64_t EmpiricalGenerator::Next() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->lastValue = NextLocked();
+}
+
+inline void EmpiricalGenerator::NextBatch(uint64_t *out, std::size_t n) {
+  if (n == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(this->mutex);
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i] = NextLocked();
+  }
+  this->lastValue = out[n - 1];
+}
+
+inline uint64_t EmpiricalGenerator::Last() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->lastValue;
+}
+
+} // namespace generators
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_EMPIRICALGENERATOR_H_
@@ -0,0 +1,97 @@
+// ExponentialGenerator.h
+
+#ifndef _DBBENCHMARK_EXPONENTIALGENERATOR_H_
+#define _DBBENCHMARK_EXPONENTIALGENERATOR_H_
+
+#include "Generator.h"
+
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+namespace dbbenchmark {
+namespace generators {
+/**
+*   \brief A generator of an exponential distribution.
+*   \details It produces a sequence of time intervals (or offsets) according to an exponential
+*       distribution. Smaller intervals are more frequent than larger ones, and there is no bound
+*       on the length of an interval. When you construct an instance of this class, you specify a
+*       parameter gamma, which corresponds to the rate at which events occur. Alternatively,
+*       1/gamma is the average interval between events, or the percentile/range pair below.
+*       CoreWorkload uses it as an offset back from the most recently inserted key.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class ExponentialGenerator : public Generator<uint64_t> {
+public:
+  ///
+  /// Default percentile of the keyspace that falls within the range.
+  ///
+  constexpr static const double kExponentialPercentile = 95.0;
+  ///
+  /// Default fraction of the keyspace that the percentile above covers.
+  ///
+  constexpr static const double kExponentialFrac = 0.8571428571;
+  /**
+  * Create an exponential generator with the given mean.
+  * @param mean The mean value of the distribution.
+  */
+  explicit ExponentialGenerator(double mean) : gamma(1.0 / mean), uniform(0.0, 1.0) { Next(); }
+  /**
+  * Create an exponential generator such that percentile% of values are smaller than range.
+  * @param percentile The percentile, in (0, 100).
+  * @param range The range of values the percentile applies to.
+  */
+  ExponentialGenerator(double percentile, double range) :
+      gamma(-std::log(1.0 - percentile / 100.0) / range), uniform(0.0, 1.0) { Next(); }
+
+  uint64_t Next() override;
+  uint64_t Last() override;
+  /**
+  * Generate n values while holding the lock once.
+  */
+  void NextBatch(uint64_t *out, std::size_t n) override;
+
+  double mean() const { return 1.0 / this->gamma; }
+
+private:
+  uint64_t NextLocked() {
+    // 1 - u keeps the argument of log() in (0, 1].
+    return static_cast<uint64_t>(-std::log(1.0 - this->uniform(this->generator)) / this->gamma);
+  }
+
+  double gamma; /// Exponential rate, the inverse of the mean
+  uint64_t lastValue;
+  std::mt19937_64 generator;
+  std::uniform_real_distribution<double> uniform;
+  std::mutex mutex;
+};
+
+inline uint64_t ExponentialGenerator::Next() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->lastValue = NextLocked();
+}
+
+inline void ExponentialGenerator::NextBatch(uint64_t *out, std::size_t n) {
+  if (n == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(this->mutex);
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i] = NextLocked();
+  }
+  this->lastValue = out[n - 1];
+}
+
+inline uint64_t ExponentialGenerator::Last() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->lastValue;
+}
+
+} // namespace generators
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_EXPONENTIALGENERATOR_H_
@@ -3,6 +3,7 @@
 #ifndef  _DBBENCHMARK_GENERATOR_H_
 #define  _DBBENCHMARK_GENERATOR_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -28,6 +29,17 @@ public:
   * @return Return the last value.
   */
   virtual Value Last() = 0;
+  /** Fill a batch of values.
+  * Default implementation calls Next() n times; generators with a cheaper
+  * bulk path (single lock, vectorized kernels) override it.
+  * @param out Destination buffer, must hold at least n values.
+  * @param n Number of values to generate.
+  */
+  virtual void NextBatch(Value *out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = Next();
+    }
+  }
   /** Destructor
   */
   virtual ~Generator() { }
@@ -0,0 +1,115 @@
+// HotspotGenerator.h
+
+#ifndef _DBBENCHMARK_HOTSPOTGENERATOR_H_
+#define _DBBENCHMARK_HOTSPOTGENERATOR_H_
+
+#include "Generator.h"
+#include "Core/Utility/Exception.h"
+
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+namespace dbbenchmark {
+namespace generators {
+/**
+*   \brief Generate integers resembling a hotspot distribution.
+*   \details x% of operations access y% of the data items. The parameters specify the bounds for the numbers,
+*       the percentage of the of the interval which comprises the hot set and the percentage of operations that
+*       access the hot set. Numbers of the hot set are always smaller than any number in the cold set. Elements
+*       from the hot set and the cold set are chosen using a uniform distribution.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class HotspotGenerator : public Generator<uint64_t> {
+public:
+  /**
+  * Create a generator for hotspot distributions.
+  * @param lower_bound Lower bound of the distribution.
+  * @param upper_bound Upper bound of the distribution.
+  * @param hotset_fraction Percentage of data item, in [0, 1].
+  * @param hot_opn_fraction Percentage of operations accessing the hot set, in [0, 1].
+  * @throw InvalidArgumentException if upper_bound is below lower_bound or the range spans all 64 bit values.
+  */
+  HotspotGenerator(uint64_t lower_bound, uint64_t upper_bound,
+                   double hotset_fraction, double hot_opn_fraction);
+
+  uint64_t Next() override;
+  uint64_t Last() override;
+  /**
+  * Generate n values while holding the lock once.
+  */
+  void NextBatch(uint64_t *out, std::size_t n) override;
+
+private:
+  uint64_t NextLocked();
+
+  uint64_t lowerBound;
+  uint64_t upperBound;
+  double hotsetFraction;
+  double hotOpnFraction;
+  uint64_t hotInterval;
+  uint64_t coldInterval;
+  uint64_t lastValue;
+  std::mt19937_64 generator;
+  std::uniform_real_distribution<double> uniform;
+  std::mutex mutex;
+};
+
+inline HotspotGenerator::HotspotGenerator(uint64_t lower_bound, uint64_t upper_bound,
+                                          double hotset_fraction, double hot_opn_fraction) :
+    lowerBound(lower_bound), upperBound(upper_bound),
+    hotsetFraction(hotset_fraction), hotOpnFraction(hot_opn_fraction), uniform(0.0, 1.0) {
+  if (this->hotsetFraction < 0.0 || this->hotsetFraction > 1.0) {
+    this->hotsetFraction = 0.0;
+  }
+  if (this->hotOpnFraction < 0.0 || this->hotOpnFraction > 1.0) {
+    this->hotOpnFraction = 0.0;
+  }
+  uint64_t interval = this->upperBound - this->lowerBound + 1;
+  if (this->lowerBound > this->upperBound || interval == 0) {
+    throw utility::InvalidArgumentException("Hotspot generator needs a range [lower_bound, upper_bound]");
+  }
+  this->hotInterval = static_cast<uint64_t>(interval * this->hotsetFraction);
+  this->coldInterval = interval - this->hotInterval;
+  Next();
+}
+
+inline uint64_t HotspotGenerator::NextLocked() {
+  if (this->hotInterval > 0 &&
+      (this->coldInterval == 0 || this->uniform(this->generator) < this->hotOpnFraction)) {
+    // Choose a value from the hot set.
+    return this->lowerBound + static_cast<uint64_t>(this->uniform(this->generator) * this->hotInterval);
+  }
+  // Choose a value from the cold set.
+  return this->lowerBound + this->hotInterval +
+      static_cast<uint64_t>(this->uniform(this->generator) * this->coldInterval);
+}
+
+inline uint64_t HotspotGenerator::Next() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->lastValue = NextLocked();
+}
+
+inline void HotspotGenerator::NextBatch(uint64_t *out, std::size_t n) {
+  if (n == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(this->mutex);
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i] = NextLocked();
+  }
+  this->lastValue = out[n - 1];
+}
+
+inline uint64_t HotspotGenerator::Last() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->lastValue;
+}
+
+} // namespace generators
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_HOTSPOTGENERATOR_H_
@@ -9,6 +9,7 @@
 #include <cstdint>
 
 #include "Core/Utility/Utils.h"
+#include "Core/Utility/VectorKernels.h"
 #include "ZipfianGenerator.h"
 
 namespace dbbenchmark {
@@ -28,38 +29,49 @@ namespace generators {
 *   \date 21/11/2018
 *   \bug None so far
 */
-class ScrambledZipfianGenerator : public Generator<uint64_t> {
+class ScrambledZipfianGenerator final : public Generator<uint64_t> {
 public:
   /**
   * Create a zipfian generator for items between min and max.
   *
   * @param min The smallest integer to generate in the sequence.
   * @param max The largest integer to generate in the sequence.
+  * @param zipfian_const The zipfian constant to use.
+  * @param hash The hash used to scatter the popular items (FNV matches YCSB).
   */
   ScrambledZipfianGenerator(uint64_t min, uint64_t max,
-      double zipfian_const = ZipfianGenerator::kZipfianConst) :
-      base(min), numItems(max - min + 1),
+      double zipfian_const = ZipfianGenerator::kZipfianConst,
+      utility::HashFunction hash = utility::FNV_HASH) :
+      base(min), numItems(max - min + 1), hash(hash),
       generator(min, max, zipfian_const) { }
   /**
   * Create a zipfian generator for the specified number of items.
   * @param items The number of items in the distribution.
+  * @param hash The hash used to scatter the popular items.
   */
-  explicit ScrambledZipfianGenerator(uint64_t num_items) :
-      ScrambledZipfianGenerator(0, num_items - 1) { }
+  explicit ScrambledZipfianGenerator(uint64_t num_items,
+      utility::HashFunction hash = utility::FNV_HASH) :
+      ScrambledZipfianGenerator(0, num_items - 1, ZipfianGenerator::kZipfianConst, hash) { }
   
   uint64_t Next() override;
   uint64_t Last() override;
+  /**
+  * Draw a batch from the underlying zipfian generator and scramble it with
+  * the vectorized hash kernel.
+  */
+  void NextBatch(uint64_t *out, std::size_t n) override;
   
 private:
   const uint64_t base;
   const uint64_t numItems;
+  const utility::HashFunction hash;
   ZipfianGenerator generator;
 
   uint64_t Scramble(uint64_t value) const;
 };
 
 inline uint64_t ScrambledZipfianGenerator::Scramble(uint64_t value) const {
-  return this->base + utility::FNVHash64(value) % this->numItems;
+  return this->base + utility::Hash(value, this->hash) % this->numItems;
 }
 /**
 * Return the next long in the sequence.
@@ -68,6 +80,14 @@ inline uint64_t ScrambledZipfianGenerator::Next() {
   return Scramble(this->generator.Next());
 }
 
+inline void ScrambledZipfianGenerator::NextBatch(uint64_t *out, std::size_t n) {
+  this->generator.NextBatch(out, n);
+  utility::HashBatch(out, out, n, this->hash);
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i] = this->base + out[i] % this->numItems;
+  }
+}
+
 inline uint64_t ScrambledZipfianGenerator::Last() {
   return Scramble(this->generator.Last());
 }
@@ -0,0 +1,68 @@
+// SequentialGenerator.h
+
+#ifndef _DBBENCHMARK_SEQUENTIALGENERATOR_H_
+#define _DBBENCHMARK_SEQUENTIALGENERATOR_H_
+
+#include "Generator.h"
+#include "Core/Utility/Exception.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace dbbenchmark {
+namespace generators {
+/**
+*   \brief Generates a sequence of integers between a start and an end value, wrapping around.
+*   \details (start, start+1, ..., end, start, start+1, ...). Unlike CounterGenerator the values
+*       stay within the given bounds, so it can be used as a key chooser to walk the keyspace in
+*       order, e.g. to exercise read-ahead.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class SequentialGenerator : public Generator<uint64_t> {
+public:
+  /** Create a counter that starts at countstart.
+  * @param start First value of the sequence.
+  * @param end Last value of the sequence (inclusive).
+  * @throw InvalidArgumentException if end is below start or the range spans all 64 bit values.
+  */
+  SequentialGenerator(uint64_t start, uint64_t end) :
+      countStart(start), interval(end - start + 1), counter(0), lastValue(start) {
+    if (start > end || this->interval == 0) {
+      throw utility::InvalidArgumentException("Sequential generator needs a range [start, end]");
+    }
+  }
+
+  uint64_t Next() override {
+    return this->lastValue = this->countStart + this->counter.fetch_add(1) % this->interval;
+  }
+  uint64_t Last() override { return this->lastValue; }
+  /** Reserve n consecutive positions with a single atomic add.
+  */
+  void NextBatch(uint64_t *out, std::size_t n) override {
+    if (n == 0) {
+      return;
+    }
+    uint64_t position = this->counter.fetch_add(n) % this->interval;
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = this->countStart + position;
+      if (++position == this->interval) {
+        position = 0;
+      }
+    }
+    this->lastValue = out[n - 1];
+  }
+
+private:
+  const uint64_t countStart;
+  const uint64_t interval;
+  std::atomic<uint64_t> counter;
+  std::atomic<uint64_t> lastValue;
+};
+
+} // namespace generators
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_SEQUENTIALGENERATOR_H_
@@ -21,7 +21,7 @@ namespace generators {
 *   \date 21/11/2018
 *   \bug None so far
 */
-class SkewedLatestGenerator : public Generator<uint64_t> {
+class SkewedLatestGenerator final : public Generator<uint64_t> {
 public:
   explicit SkewedLatestGenerator(CounterGenerator &counter) :
       basis(counter), zipfian(this->basis.Last()) {
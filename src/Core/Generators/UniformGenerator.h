@@ -4,6 +4,7 @@
 #define _DBBENCHMARK_UNIFORMGENERATOR_H_
 
 #include "Generator.h"
+#include "Core/Utility/Exception.h"
 
 #include <atomic>
 #include <mutex>
@@ -19,12 +20,18 @@ namespace generators {
 *   \date 21/11/2018
 *   \bug None so far
 */
-class UniformGenerator : public Generator<uint64_t> {
+class UniformGenerator final : public Generator<uint64_t> {
 public:
   /**
   * Creates a generator that will return strings from the specified set uniformly randomly.
+  * @throw InvalidArgumentException if max is below min.
   */
-  UniformGenerator(uint64_t min, uint64_t max) : dist_(min, max) { Next(); }
+  UniformGenerator(uint64_t min, uint64_t max) : dist_(min, min > max ? min : max) {
+    if (min > max) {
+      throw utility::InvalidArgumentException("Uniform generator needs a range [min, max]");
+    }
+    Next();
+  }
   /**
   * Generate the next string in the distribution.
   */
@@ -35,6 +42,10 @@ public:
  * been called, lastString() should return something reasonable.
  */
   uint64_t Last();
+  /**
+  * Generate n values while holding the lock once.
+  */
+  void NextBatch(uint64_t *out, std::size_t n) override;
   
 private:
   std::mt19937_64 generator_;
@@ -48,6 +59,17 @@ inline uint64_t UniformGenerator::Next() {
   return last_int_ = dist_(generator_);
 }
 
+inline void UniformGenerator::NextBatch(uint64_t *out, std::size_t n) {
+  if (n == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i] = dist_(generator_);
+  }
+  last_int_ = out[n - 1];
+}
+
 inline uint64_t UniformGenerator::Last() {
   std::lock_guard<std::mutex> lock(mutex_);
   return last_int_;
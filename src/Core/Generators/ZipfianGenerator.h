@@ -43,6 +43,7 @@ class ZipfianGenerator : public Generator<uint64_t> {
 public:
   constexpr static const double kZipfianConst = 0.99;
   static const uint64_t kMaxNumItems = (UINT64_MAX >> 24);
+  static const std::size_t kBatchChunk = 64; /// Uniform draws buffered per NextBatch() step
   /**
  * Create a zipfian generator for items between min and max (inclusive) for the specified zipfian constant.
  * @param min The smallest integer to generate in the sequence.
@@ -71,6 +72,12 @@ public:
   uint64_t Next(uint64_t num_items);
   
   uint64_t Next() override { return Next(this->numItems); }
+  /**
+  * Generate n items while holding the lock once. Uniform draws are taken
+  * kBatchChunk at a time and the inverse-CDF transform then runs over the
+  * chunk, which keeps that loop free of calls into the RNG.
+  */
+  void NextBatch(uint64_t *out, std::size_t n) override;
 
   uint64_t Last() override;
   
@@ -149,6 +156,38 @@ inline uint64_t ZipfianGenerator::Next(uint64_t num) {
   return this->lastValue = this->base + num * std::pow(this->eta * u - this->eta + 1, this->alpha);
 }
 
+inline void ZipfianGenerator::NextBatch(uint64_t *out, std::size_t n) {
+  if (n == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(this->mutex);
+  const uint64_t num = this->numItems;
+  if (num > this->nforZeta) {
+    RaiseZeta(num);
+    this->eta = Eta();
+  }
+  const double secondLimit = 1.0 + std::pow(0.5, this->theta);
+  double uniforms[kBatchChunk];
+  for (std::size_t done = 0; done < n; done += kBatchChunk) {
+    const std::size_t chunk = (n - done < kBatchChunk) ? n - done : kBatchChunk;
+    for (std::size_t i = 0; i < chunk; ++i) {
+      uniforms[i] = utility::RandomDouble();
+    }
+    for (std::size_t i = 0; i < chunk; ++i) {
+      double u = uniforms[i];
+      double uz = u * this->zetaN;
+      if (uz < 1.0) {
+        out[done + i] = 0;
+      } else if (uz < secondLimit) {
+        out[done + i] = 1;
+      } else {
+        out[done + i] = this->base + num * std::pow(this->eta * u - this->eta + 1, this->alpha);
+      }
+    }
+  }
+  this->lastValue = out[n - 1];
+}
+
 inline uint64_t ZipfianGenerator::Last() {
   std::lock_guard<std::mutex> lock(this->mutex);
   return this->lastValue;
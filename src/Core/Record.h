@@ -0,0 +1,179 @@
+// Record.h
+
+#ifndef _DBBENCHMARK_RECORD_H_
+#define _DBBENCHMARK_RECORD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dbbenchmark {
+
+///
+/// Kind of data a field value holds. Every value is passed as bytes; bindings
+/// that store typed data (e.g. BSON) use the type to convert it.
+///
+enum PayloadType : uint8_t {
+  ASCII_PAYLOAD,   /// Printable characters
+  BINARY_PAYLOAD,  /// Arbitrary bytes, including NUL
+  JSON_PAYLOAD,    /// A JSON document with nested fields
+  INTEGER_PAYLOAD, /// A signed 64 bit integer in decimal
+  UUID_PAYLOAD,    /// A version 4 UUID in its 36 character text form
+  COUNTER_PAYLOAD  /// A 64 bit integer in decimal, one more than the previous value
+};
+
+///
+/// One field of a record to write. Both members are views: the name usually points
+/// into the workload's field-name table and the value into a ValuePool or PayloadPool.
+///
+struct FieldValue {
+  std::string_view field;
+  std::string_view value;
+  PayloadType type = ASCII_PAYLOAD;
+};
+
+/**
+*   \brief Non-owning view of the field/value pairs of one record.
+*   \details Passed by value to DB::insert and DB::update in place of a vector of string pairs, so
+*       a record goes from the workload to the binding without copying a single byte. The caller
+*       keeps the fields, and the buffers they point into, alive for the duration of the call;
+*       bindings that need the data afterwards must copy it.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class RecordView {
+public:
+  typedef const FieldValue *const_iterator;
+
+  RecordView() : m_fields(nullptr), m_size(0) { }
+  RecordView(const FieldValue *fields, std::size_t size) : m_fields(fields), m_size(size) { }
+  RecordView(const std::vector<FieldValue> &fields) : m_fields(fields.data()), m_size(fields.size()) { }
+
+  const_iterator begin() const { return m_fields; }
+  const_iterator end() const { return m_fields + m_size; }
+  const FieldValue &operator[](std::size_t index) const { return m_fields[index]; }
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+private:
+  const FieldValue *m_fields;
+  std::size_t m_size;
+};
+
+///
+/// One record of a batch write: its key and its field/value pairs, both views
+/// with the same lifetime rules as the arguments of DB::insert.
+///
+struct KeyedRecord {
+  std::string_view key;
+  RecordView values;
+};
+
+/**
+*   \brief Non-owning list of field names to read.
+*   \details Usually points into the workload's interned field-name table, so choosing the fields of a
+*       read or scan allocates nothing. An empty list means all fields.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class FieldList {
+public:
+  typedef const std::string *const_iterator;
+
+  FieldList() : m_names(nullptr), m_size(0) { }
+  FieldList(const std::string *names, std::size_t size) : m_names(names), m_size(size) { }
+  FieldList(const std::vector<std::string> &names) : m_names(names.data()), m_size(names.size()) { }
+
+  const_iterator begin() const { return m_names; }
+  const_iterator end() const { return m_names + m_size; }
+  const std::string &operator[](std::size_t index) const { return m_names[index]; }
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+private:
+  const std::string *m_names;
+  std::size_t m_size;
+};
+
+template <typename T> class ReusedVector;
+
+/// Empty an element of a ReusedVector for reuse, keeping its storage.
+inline void ResetElement(std::pair<std::string, std::string> &pair) {
+  pair.first.clear();
+  pair.second.clear();
+}
+template <typename T>
+inline void ResetElement(ReusedVector<T> &elements) {
+  elements.clear();
+}
+
+/**
+*   \brief A vector whose elements outlive clear().
+*   \details clear() and shrinking only lower the count of live elements; the ones past it keep
+*       their strings and vectors, and emplace_back() hands them out again, emptied. Read and scan
+*       results are filled into these, so once a client's buffers have grown to the largest
+*       result, reading a record copies bytes into existing storage and allocates nothing.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+template <typename T>
+class ReusedVector {
+public:
+  typedef T *iterator;
+  typedef const T *const_iterator;
+
+  ReusedVector() : m_size(0) { }
+
+  iterator begin() { return m_elements.data(); }
+  iterator end() { return m_elements.data() + m_size; }
+  const_iterator begin() const { return m_elements.data(); }
+  const_iterator end() const { return m_elements.data() + m_size; }
+  T &operator[](std::size_t index) { return m_elements[index]; }
+  const T &operator[](std::size_t index) const { return m_elements[index]; }
+  T &back() { return m_elements[m_size - 1]; }
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  /** Forget the elements; their storage is kept for the next ones. */
+  void clear() { m_size = 0; }
+  /** Append an empty element, reusing one that was cleared if there is one. */
+  T &emplace_back() {
+    if (m_size == m_elements.size()) {
+      m_elements.emplace_back();
+    } else {
+      ResetElement(m_elements[m_size]);
+    }
+    return m_elements[m_size++];
+  }
+  void pop_back() { --m_size; }
+  /** Keep the first size elements, or append empty ones up to size. */
+  void resize(std::size_t size) {
+    while (m_size < size) {
+      emplace_back();
+    }
+    m_size = size;
+  }
+
+private:
+  std::vector<T> m_elements;
+  std::size_t m_size; /// Live elements, the first m_size of m_elements
+};
+
+///
+/// Field/value pairs a read returns, and the records a scan returns.
+///
+typedef ReusedVector<std::pair<std::string, std::string>> ReadResult;
+typedef ReusedVector<ReadResult> ScanResult;
+
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_RECORD_H_
@@ -2,7 +2,9 @@
 
 #include "Status.h"
 
+#include <cstring>
 #include <functional>
+#include <string_view>
 
 namespace dbbenchmark {
 namespace utility {
@@ -21,26 +23,30 @@ Status Status::SERVICE_UNAVAILABLE("SERVICE_UNAVAILABLE", "Dependant"
 Status Status::BATCHED_OK("BATCHED_OK", "The operation has been batched by"
     " the binding to be executed later.");
 
-Status::Status(const std::string &nameIn, const std::string &descriptionIn) : name(nameIn),
+Status::Status(const char *nameIn, const char *descriptionIn) : name(nameIn),
 description(descriptionIn) {
 }
 
 std::string Status::toString() const {
     std::string tmp;
-    tmp = "Status [name=" + name + ", description=" + description + "]";
+    tmp = std::string("Status [name=") + name + ", description=" + description + "]";
     return tmp; 
 };
 
 int Status::hashCode() const {
     const int prime = 31;
     int result = 1;
-    result = ((prime * result) + (description.empty())) ? 0 : std::hash<std::string>{}(description);
-    result = ((prime * result) + (name.empty())) ? 0 : std::hash<std::string>{}(name);
+    result = ((prime * result) + (*description == '\0')) ? 0 : std::hash<std::string_view>{}(description);
+    result = ((prime * result) + (*name == '\0')) ? 0 : std::hash<std::string_view>{}(name);
     return result;
 }
 
 bool Status::isEqual(const Status& statusToCompare) const {
-    return ((this->description == statusToCompare.description) && (this->name == statusToCompare.name));
+    if (this->name == statusToCompare.name && this->description == statusToCompare.description) {
+        return true;
+    }
+    return (std::strcmp(this->description, statusToCompare.description) == 0)
+        && (std::strcmp(this->name, statusToCompare.name) == 0);
 }
 
 } // namespace utility
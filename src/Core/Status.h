@@ -31,10 +31,11 @@ public:
     static Status BATCHED_OK;
     
 public:
-    /** Constructor.
+    /** Constructor. Statuses are returned by value from every operation, so only the
+     * pointers are copied; both strings must outlive the status (string literals do).
      * @param name A short name for the status.
      * @param description A description of the status. */
-    Status(const std::string &name = "", const std::string &description = "");
+    Status(const char *name = "", const char *description = "");
     /** 
      * @return Name of status.*/
     std::string getName() const { return this->name; };
@@ -65,8 +66,8 @@ public:
 protected:
 
 private:
-    std::string name;   // TODO_purpose_and_units.
-    std::string description;   // TODO_purpose_and_units.
+    const char *name;   // TODO_purpose_and_units.
+    const char *description;   // TODO_purpose_and_units.
     /**
      * Is {@code this} a passing state for the operation: {@link Status#OK} or {@link Status#BATCHED_OK}.
      * @return true if the operation is successful, false otherwise
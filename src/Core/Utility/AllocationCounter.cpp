@@ -0,0 +1,70 @@
+// AllocationCounter.cpp
+
+#include "AllocationCounter.h"
+
+#ifdef DBBENCHMARK_COUNT_ALLOCATIONS
+
+#include <cstdlib>
+#include <new>
+
+using dbbenchmark::utility::AllocationCounter;
+
+// Replacements of the global allocation functions. Every other form of
+// operator new and delete forwards to one of these, so they are all counted.
+
+void *operator new(std::size_t size) {
+  AllocationCounter::Increment();
+  void *memory = std::malloc(size == 0 ? 1 : size);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  AllocationCounter::Increment();
+  std::size_t align = static_cast<std::size_t>(alignment);
+  if (align < sizeof(void *)) {
+    align = sizeof(void *);
+  }
+  void *memory = nullptr;
+  if (::posix_memalign(&memory, align, size == 0 ? 1 : size) != 0) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void *operator new[](std::size_t size) {
+  return ::operator new(size);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+  return ::operator new(size, alignment);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return ::operator new(size);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return ::operator new(size);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+
+#endif // DBBENCHMARK_COUNT_ALLOCATIONS
@@ -0,0 +1,46 @@
+// AllocationCounter.h
+
+#ifndef _DBBENCHMARK_ALLOCATIONCOUNTER_H_
+#define _DBBENCHMARK_ALLOCATIONCOUNTER_H_
+
+#include <cstdint>
+
+namespace dbbenchmark {
+namespace utility {
+/**
+*   \brief Per-thread count of heap allocations made through global operator new.
+*   \details Counting only happens when the program is built with DBBENCHMARK_COUNT_ALLOCATIONS
+*       (make COUNT_ALLOCATIONS=on), which replaces the global allocation functions in
+*       AllocationCounter.cpp. Otherwise Enabled() is false and Count() stays zero. Comparing Count()
+*       before and after a loop of operations shows whether the steady-state hot path allocates.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class AllocationCounter {
+public:
+  /** Whether allocations are being counted in this build.
+  */
+  static constexpr bool Enabled() {
+#ifdef DBBENCHMARK_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /** Number of allocations the calling thread has made so far.
+  */
+  static uint64_t Count() { return s_count; }
+
+  static void Increment() { ++s_count; }
+
+private:
+  static inline thread_local uint64_t s_count = 0;
+};
+
+} // namespace utility
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_ALLOCATIONCOUNTER_H_
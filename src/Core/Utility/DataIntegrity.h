@@ -0,0 +1,260 @@
+// DataIntegrity.h
+
+#ifndef _DBBENCHMARK_DATAINTEGRITY_H_
+#define _DBBENCHMARK_DATAINTEGRITY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "Utils.h"
+
+namespace dbbenchmark {
+namespace utility {
+/**
+*   \brief Field values that are a pure function of (key, field, version).
+*   \details A value starts with a kHeaderSize byte header holding its version in base 64 digits. A
+*       version is the id of the client that wrote the value and that client's sequence number, so
+*       versions of one writer are ordered and versions of different writers are not. The
+*       rest is a SplitMix64 stream seeded from the key, the field and the version, taken as raw bytes
+*       or mapped onto printable characters eight at a time. Nothing is kept in memory: a value read
+*       back is checked by recomputing it from the version in its own header, so a value of another
+*       key or field, a torn write or a flipped bit makes the check fail. Checking costs one hash
+*       round and one compare per eight bytes.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class DeterministicValue {
+public:
+  /// Length of the version header, and so the shortest value.
+  static constexpr std::size_t kHeaderSize = 8;
+  /// Largest version the header can hold.
+  static constexpr uint64_t kMaxVersion = (1ULL << (6 * kHeaderSize)) - 1;
+  /// Low bits of a version that hold the writer's sequence number; the rest hold the writer.
+  static constexpr unsigned kSequenceBits = 32;
+  static constexpr uint64_t kMaxSequence = (1ULL << kSequenceBits) - 1;
+  static constexpr uint64_t kMaxWriter = kMaxVersion >> kSequenceBits;
+
+  /// Version of write sequence of writer; both wrap to fit the header.
+  static uint64_t Version(uint64_t writer, uint64_t sequence) {
+    return ((writer & kMaxWriter) << kSequenceBits) | (sequence & kMaxSequence);
+  }
+  static uint64_t Writer(uint64_t version) { return version >> kSequenceBits; }
+  static uint64_t Sequence(uint64_t version) { return version & kMaxSequence; }
+
+  /** Write the value of (key_num, field_id, version).
+  * @param out Destination of length bytes, length at least kHeaderSize.
+  * @param binary Raw bytes instead of printable characters.
+  */
+  static void Fill(char *out, std::size_t length, uint64_t key_num, uint64_t field_id,
+                   uint64_t version, bool binary);
+
+  /** Check that value is the value of (key_num, field_id) at the version in its header.
+  * @param version Receives the version of an intact value.
+  * @return false if the value is corrupt.
+  */
+  static bool Verify(std::string_view value, uint64_t key_num, uint64_t field_id, bool binary,
+                     uint64_t &version);
+
+private:
+  static const uint64_t kGolden = 0x9E3779B97F4A7C15;
+  static const uint64_t kLowBytes = 0x00FF00FF00FF00FF;
+  static const uint64_t kPrintableBase = 0x2121212121212121; // '!' in every byte
+
+  static uint64_t Seed(uint64_t key_num, uint64_t field_id, uint64_t version) {
+    return MixHash64(MixHash64(MixHash64(key_num + kGolden) ^ field_id) ^ version);
+  }
+
+  /// Next eight bytes of the stream.
+  static uint64_t Word(uint64_t &state, bool binary) {
+    state += kGolden;
+    uint64_t word = MixHash64(state);
+    if (binary) {
+      return word;
+    }
+    // Scale every byte onto the 94 printable characters '!'..'~', as ValuePool
+    // does, four bytes per multiply: a byte times 94 fits its 16 bit lane.
+    uint64_t even = (((word & kLowBytes) * 94) >> 8) & kLowBytes;
+    uint64_t odd = ((((word >> 8) & kLowBytes) * 94) >> 8) & kLowBytes;
+    return (even | (odd << 8)) + kPrintableBase;
+  }
+
+  static char Digit(uint64_t value) {
+    return "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz+/"[value & 63];
+  }
+
+  static int DigitValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'z') return c - 'a' + 36;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+  }
+};
+
+inline void DeterministicValue::Fill(char *out, std::size_t length, uint64_t key_num,
+                                     uint64_t field_id, uint64_t version, bool binary) {
+  for (std::size_t i = 0; i < kHeaderSize; ++i) {
+    out[i] = Digit(version >> (6 * i));
+  }
+  uint64_t state = Seed(key_num, field_id, version);
+  std::size_t pos = kHeaderSize;
+  for (; pos + sizeof(uint64_t) <= length; pos += sizeof(uint64_t)) {
+    uint64_t word = Word(state, binary);
+    std::memcpy(out + pos, &word, sizeof(word));
+  }
+  if (pos < length) {
+    uint64_t word = Word(state, binary);
+    std::memcpy(out + pos, &word, length - pos);
+  }
+}
+
+inline bool DeterministicValue::Verify(std::string_view value, uint64_t key_num, uint64_t field_id,
+                                       bool binary, uint64_t &version) {
+  if (value.size() < kHeaderSize) {
+    return false;
+  }
+  version = 0;
+  for (std::size_t i = 0; i < kHeaderSize; ++i) {
+    int digit = DigitValue(value[i]);
+    if (digit < 0) {
+      return false;
+    }
+    version |= static_cast<uint64_t>(digit) << (6 * i);
+  }
+  uint64_t state = Seed(key_num, field_id, version);
+  std::size_t pos = kHeaderSize;
+  for (; pos + sizeof(uint64_t) <= value.size(); pos += sizeof(uint64_t)) {
+    uint64_t word = Word(state, binary);
+    if (std::memcmp(value.data() + pos, &word, sizeof(word)) != 0) {
+      return false;
+    }
+  }
+  if (pos < value.size()) {
+    uint64_t word = Word(state, binary);
+    return std::memcmp(value.data() + pos, &word, value.size() - pos) == 0;
+  }
+  return true;
+}
+
+/**
+*   \brief Bump allocator for values that are computed rather than sliced from a pool.
+*   \details Memory comes in blocks that never move, so views of earlier values stay valid while
+*       later ones are allocated. Reset() rewinds to the first block and keeps the memory.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class ValueArena {
+public:
+  static const std::size_t kBlockSize = (1 << 20);
+
+  ValueArena() : m_block(0), m_used(0) { }
+
+  char *Allocate(std::size_t length) {
+    for (; m_block < m_blocks.size(); ++m_block, m_used = 0) {
+      if (m_used + length <= m_sizes[m_block]) {
+        char *data = m_blocks[m_block].get() + m_used;
+        m_used += length;
+        return data;
+      }
+    }
+    std::size_t size = (length > kBlockSize ? length : kBlockSize);
+    m_blocks.emplace_back(new char[size]);
+    m_sizes.push_back(size);
+    m_used = length;
+    return m_blocks.back().get();
+  }
+
+  void Reset() {
+    m_block = 0;
+    m_used = 0;
+  }
+
+private:
+  std::vector<std::unique_ptr<char[]>> m_blocks;
+  std::vector<std::size_t> m_sizes;
+  std::size_t m_block; /// Block allocations are taken from
+  std::size_t m_used;  /// Bytes used in that block
+};
+
+///
+/// Outcome of verified reads: intact values at the expected version, intact
+/// values older than a write this client already completed, and values that
+/// do not match their key, field and version.
+///
+struct VerificationCounts {
+  uint64_t verified = 0;
+  uint64_t stale = 0;
+  uint64_t corrupt = 0;
+
+  VerificationCounts &operator+=(const VerificationCounts &other) {
+    verified += other.verified;
+    stale += other.stale;
+    corrupt += other.corrupt;
+    return *this;
+  }
+};
+
+/**
+*   \brief The versions a client wrote most recently, for read-your-writes checks.
+*   \details A direct-mapped table of kSlots entries; a write evicts whatever shared its slot, so
+*       memory stays constant and an evicted key is simply not checked for staleness.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class WriteVersionCache {
+public:
+  static const std::size_t kSlots = 4096;
+  /// Field id of a write that covered every field of the record.
+  static const uint32_t kAllFields = UINT32_MAX;
+
+  WriteVersionCache() : m_slots(kSlots) { }
+
+  void Record(std::size_t table, uint64_t key_num, uint32_t field_id, uint64_t version) {
+    Slot &slot = m_slots[Index(table, key_num)];
+    slot.keyNum = key_num;
+    slot.table = static_cast<uint32_t>(table);
+    slot.fieldId = field_id;
+    slot.version = version;
+  }
+
+  /** Version a read of the field must return at least, 0 if unknown.
+  */
+  uint64_t Expected(std::size_t table, uint64_t key_num, uint64_t field_id) const {
+    const Slot &slot = m_slots[Index(table, key_num)];
+    if (slot.keyNum == key_num && slot.table == table &&
+        (slot.fieldId == kAllFields || slot.fieldId == field_id)) {
+      return slot.version;
+    }
+    return 0;
+  }
+
+private:
+  struct Slot {
+    uint64_t keyNum = 0;
+    uint64_t version = 0;
+    uint32_t table = 0;
+    uint32_t fieldId = 0;
+  };
+
+  static std::size_t Index(std::size_t table, uint64_t key_num) {
+    return MixHash64(key_num ^ (static_cast<uint64_t>(table) << 56)) % kSlots;
+  }
+
+  std::vector<Slot> m_slots;
+};
+
+} // namespace utility
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_DATAINTEGRITY_H_
@@ -0,0 +1,109 @@
+// KeyBuffer.h
+
+#ifndef _DBBENCHMARK_KEYBUFFER_H_
+#define _DBBENCHMARK_KEYBUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace dbbenchmark {
+namespace utility {
+
+///
+/// Number of decimal digits of value (1 for 0).
+///
+inline std::size_t DecimalDigits(uint64_t value) {
+  std::size_t digits = 1;
+  for (;;) {
+    if (value < 10) return digits;
+    if (value < 100) return digits + 1;
+    if (value < 1000) return digits + 2;
+    if (value < 10000) return digits + 3;
+    value /= 10000;
+    digits += 4;
+  }
+}
+
+///
+/// Write the digits-long decimal representation of value, which must have
+/// exactly that many digits, ending right before end. Two digits are
+/// produced per division using a lookup table.
+///
+inline void WriteDecimal(uint64_t value, char *end) {
+  static const char kDigitPairs[201] =
+      "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+      "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+  while (value >= 100) {
+    const char *pair = kDigitPairs + (value % 100) * 2;
+    value /= 100;
+    *--end = pair[1];
+    *--end = pair[0];
+  }
+  if (value >= 10) {
+    const char *pair = kDigitPairs + value * 2;
+    *--end = pair[1];
+    *--end = pair[0];
+  } else {
+    *--end = static_cast<char>('0' + value);
+  }
+}
+
+/**
+*   \brief Fixed-capacity buffer a record key is formatted into.
+*   \details Formats prefix + zero padded decimal number without touching the heap. Each client
+*       thread owns one and reuses it for every operation; the view returned by Format() stays valid
+*       until the next call. The key is always followed by a NUL byte, so bindings whose client
+*       libraries want C strings can pass view.data() directly.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class KeyBuffer {
+public:
+  /// Capacity in bytes, including the terminating NUL.
+  static const std::size_t kCapacity = 128;
+  /// Longest decimal representation of a uint64_t.
+  static const std::size_t kMaxDigits = 20;
+
+  KeyBuffer() : m_size(0) { m_data[0] = '\0'; }
+
+  /** Check that every key with this prefix and padding fits in the buffer.
+  */
+  static bool Fits(std::size_t prefix_len, std::size_t zero_padding) {
+    return prefix_len + (zero_padding > kMaxDigits ? zero_padding : kMaxDigits) < kCapacity;
+  }
+
+  /** Format a key. The prefix and padding must satisfy Fits().
+  * @param prefix Key prefix, e.g. "user".
+  * @param key_num Record number.
+  * @param zero_padding Minimum number of digits; shorter numbers are padded with leading zeros.
+  * @return View of the key, valid until the next Format().
+  */
+  std::string_view Format(std::string_view prefix, uint64_t key_num, std::size_t zero_padding) {
+    std::size_t digits = DecimalDigits(key_num);
+    std::size_t width = digits < zero_padding ? zero_padding : digits;
+    std::memcpy(m_data, prefix.data(), prefix.size());
+    char *number = m_data + prefix.size();
+    std::memset(number, '0', width - digits);
+    WriteDecimal(key_num, number + width);
+    m_size = prefix.size() + width;
+    m_data[m_size] = '\0';
+    return view();
+  }
+
+  std::string_view view() const { return std::string_view(m_data, m_size); }
+  const char *c_str() const { return m_data; }
+
+private:
+  char m_data[kCapacity];
+  std::size_t m_size;
+};
+
+} // namespace utility
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_KEYBUFFER_H_
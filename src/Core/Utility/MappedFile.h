@@ -0,0 +1,88 @@
+// MappedFile.h
+
+#ifndef _DBBENCHMARK_MAPPEDFILE_H_
+#define _DBBENCHMARK_MAPPEDFILE_H_
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Exception.h"
+
+namespace dbbenchmark {
+namespace utility {
+/**
+*   \brief Read-only memory mapping of a whole file.
+*   \details The mapping lives as long as the object. Pages are shared between every thread
+*       (and process) reading the same file, so large binary inputs such as histograms and
+*       operation streams cost no heap and no parsing.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class MappedFile {
+public:
+  /** Map a file.
+  * @param filePath Path of the file to map.
+  * @throw FileException if the file cannot be opened or mapped.
+  */
+  explicit MappedFile(const std::string &filePath) : m_data(nullptr), m_size(0) {
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw FileException("Cannot open file " + filePath, std::strerror(errno));
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      int error = errno;
+      ::close(fd);
+      throw FileException("Cannot stat file " + filePath, std::strerror(error));
+    }
+    m_size = static_cast<std::size_t>(st.st_size);
+    if (m_size > 0) {
+      void *addr = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+      if (addr == MAP_FAILED) {
+        int error = errno;
+        ::close(fd);
+        throw FileException("Cannot map file " + filePath, std::strerror(error));
+      }
+      m_data = static_cast<const char *>(addr);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() {
+    if (m_data != nullptr) {
+      ::munmap(const_cast<char *>(m_data), m_size);
+    }
+  }
+  /** Tell the kernel the file is about to be read front to back.
+  */
+  void adviseSequential() const {
+    if (m_data != nullptr) {
+      ::madvise(const_cast<char *>(m_data), m_size, MADV_SEQUENTIAL);
+    }
+  }
+
+  const char *data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+
+private:
+  const char *m_data;
+  std::size_t m_size;
+};
+
+} // namespace utility
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_MAPPEDFILE_H_
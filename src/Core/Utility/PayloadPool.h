@@ -0,0 +1,184 @@
+// PayloadPool.h
+
+#ifndef _DBBENCHMARK_PAYLOADPOOL_H_
+#define _DBBENCHMARK_PAYLOADPOOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Core/Record.h"
+#include "Exception.h"
+#include "ValuePool.h"
+
+namespace dbbenchmark {
+namespace utility {
+/**
+*   \brief Pre-generated structured field values: JSON documents, integers, UUIDs or counters.
+*   \details Holds kEntries values of one PayloadType, built once and stored back to back in a
+*       single buffer. Next() hands out views of them, walking the entries with a fixed stride, so
+*       producing a structured value costs no formatting and no allocation. JSON documents follow a
+*       fixed schema with nested objects and arrays; integers are spread over all magnitudes, from
+*       small counters to full 64 bit values. Counter pools hold consecutive integers from a random
+*       start and are walked one entry at a time, so successive values count up by one and wrap back
+*       every kEntries values. Printable and binary values come from ValuePool.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class PayloadPool {
+public:
+  /// Number of distinct values in a pool. A power of two, walked with an odd stride.
+  static constexpr std::size_t kEntries = 4096;
+
+  /** Build a pool.
+  * @param type JSON_PAYLOAD, INTEGER_PAYLOAD, UUID_PAYLOAD or COUNTER_PAYLOAD.
+  * @param seed Seed of the random content.
+  * @throw InvalidArgumentException for the other payload types.
+  */
+  PayloadPool(PayloadType type, uint64_t seed);
+
+  /** Pool of the calling thread for the given type, created on first use and rebuilt if
+  * a different seed is asked for. Next() starts at a different entry in each thread.
+  */
+  static PayloadPool &ThreadLocal(PayloadType type, uint64_t seed = 0);
+
+  /** Next value of the pool, valid for the lifetime of the pool.
+  */
+  std::string_view Next() {
+    m_cursor = (m_cursor + m_stride) % kEntries;
+    return (*this)[m_cursor];
+  }
+
+  /** Value at position, which wraps around the pool. Successive positions are as far apart
+  * as successive Next() values. Does not move Next().
+  */
+  std::string_view At(uint64_t position) const {
+    return (*this)[(position * m_stride) % kEntries];
+  }
+
+  std::string_view operator[](std::size_t index) const {
+    return std::string_view(m_buffer.data() + m_offsets[index], m_offsets[index + 1] - m_offsets[index]);
+  }
+  PayloadType type() const { return m_type; }
+  uint64_t seed() const { return m_seed; }
+
+private:
+  static constexpr std::size_t kStride = 1031;
+
+  void AppendJson(std::mt19937_64 &generator);
+  void AppendInteger(std::mt19937_64 &generator);
+  void AppendUuid(std::mt19937_64 &generator);
+  void AppendWord(std::mt19937_64 &generator, std::size_t min_len, std::size_t max_len);
+
+  const PayloadType m_type;
+  const uint64_t m_seed;
+  const std::size_t m_stride; /// kStride, or 1 for counters
+  std::string m_buffer;
+  std::vector<uint32_t> m_offsets; /// kEntries + 1 offsets into m_buffer
+  std::size_t m_cursor;
+};
+
+inline PayloadPool::PayloadPool(PayloadType type, uint64_t seed) :
+    m_type(type), m_seed(seed), m_stride(type == COUNTER_PAYLOAD ? 1 : kStride), m_cursor(0) {
+  if (type != JSON_PAYLOAD && type != INTEGER_PAYLOAD && type != UUID_PAYLOAD && type != COUNTER_PAYLOAD) {
+    throw InvalidArgumentException("Payload pools hold json, integer, uuid or counter values");
+  }
+  std::mt19937_64 generator(seed);
+  // Leaves room below INT64_MAX, so no counter value overflows.
+  const uint64_t counter_start = generator() >> 2;
+  m_offsets.reserve(kEntries + 1);
+  for (std::size_t i = 0; i < kEntries; ++i) {
+    m_offsets.push_back(static_cast<uint32_t>(m_buffer.size()));
+    switch (type) {
+      case JSON_PAYLOAD:
+        AppendJson(generator);
+        break;
+      case INTEGER_PAYLOAD:
+        AppendInteger(generator);
+        break;
+      case COUNTER_PAYLOAD:
+        m_buffer.append(std::to_string(counter_start + i));
+        break;
+      default:
+        AppendUuid(generator);
+        break;
+    }
+  }
+  m_offsets.push_back(static_cast<uint32_t>(m_buffer.size()));
+}
+
+inline PayloadPool &PayloadPool::ThreadLocal(PayloadType type, uint64_t seed) {
+  thread_local std::unique_ptr<PayloadPool> pools[COUNTER_PAYLOAD + 1];
+  std::unique_ptr<PayloadPool> &pool = pools[type];
+  if (!pool || pool->m_seed != seed) {
+    pool.reset(new PayloadPool(type, seed));
+    // Threads share the seed, so they start walking at different entries.
+    pool->m_cursor = std::hash<std::thread::id>()(std::this_thread::get_id()) % kEntries;
+  }
+  return *pool;
+}
+
+inline void PayloadPool::AppendWord(std::mt19937_64 &generator, std::size_t min_len, std::size_t max_len) {
+  static const char kAlphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+  std::size_t length = min_len + generator() % (max_len - min_len + 1);
+  for (std::size_t i = 0; i < length; ++i) {
+    m_buffer.push_back(kAlphabet[generator() % (sizeof(kAlphabet) - 1)]);
+  }
+}
+
+inline void PayloadPool::AppendInteger(std::mt19937_64 &generator) {
+  // Shifting by a random amount spreads the values evenly over magnitudes.
+  int64_t value = static_cast<int64_t>(generator()) >> (generator() % 64);
+  m_buffer.append(std::to_string(value));
+}
+
+inline void PayloadPool::AppendUuid(std::mt19937_64 &generator) {
+  static const char kHex[] = "0123456789abcdef";
+  uint64_t high = generator();
+  uint64_t low = generator();
+  high = (high & ~0xf000ULL) | 0x4000ULL; // version 4
+  low = (low & ~(0xcULL << 60)) | (0x8ULL << 60); // RFC 4122 variant
+  for (int i = 0; i < 32; ++i) {
+    if (i == 8 || i == 12 || i == 16 || i == 20) {
+      m_buffer.push_back('-');
+    }
+    uint64_t word = (i < 16 ? high : low);
+    m_buffer.push_back(kHex[(word >> (60 - 4 * (i % 16))) & 0xf]);
+  }
+}
+
+inline void PayloadPool::AppendJson(std::mt19937_64 &generator) {
+  m_buffer.append("{\"id\":").append(std::to_string(generator() % 1000000000));
+  m_buffer.append(",\"name\":\"");
+  AppendWord(generator, 4, 16);
+  m_buffer.append("\",\"active\":").append(generator() % 2 ? "true" : "false");
+  m_buffer.append(",\"score\":").append(std::to_string(generator() % 100000 / 100.0));
+  m_buffer.append(",\"tags\":[");
+  std::size_t tags = 1 + generator() % 4;
+  for (std::size_t i = 0; i < tags; ++i) {
+    m_buffer.append(i == 0 ? "\"" : ",\"");
+    AppendWord(generator, 3, 10);
+    m_buffer.push_back('"');
+  }
+  m_buffer.append("],\"address\":{\"street\":\"");
+  AppendWord(generator, 6, 20);
+  m_buffer.append("\",\"city\":\"");
+  AppendWord(generator, 4, 12);
+  m_buffer.append("\",\"zip\":").append(std::to_string(10000 + generator() % 90000));
+  m_buffer.append("},\"stats\":{\"views\":").append(std::to_string(generator() % 1000000));
+  m_buffer.append(",\"likes\":").append(std::to_string(generator() % 10000));
+  m_buffer.append("}}");
+}
+
+} // namespace utility
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_PAYLOADPOOL_H_
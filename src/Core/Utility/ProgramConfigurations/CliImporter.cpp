@@ -23,7 +23,11 @@ void CliImporter::readProperties() {
         ("loglevel, loglvl", boost::program_options::value<std::string>(),"logging severity level")
         ("threads, t", boost::program_options::value<std::string>(),"execute using n threads(default: 1)")
         ("dbname, db", boost::program_options::value<std::string>(),
-            "specify the name of the DB to use (default: basic)");
+            "specify the name of the DB to use (default: basic)")
+        ("mode, m", boost::program_options::value<std::string>(),
+            "run, generate (write an operation stream) or replay (execute one) (default: run)")
+        ("operationstream, o", boost::program_options::value<std::string>(),
+            "operation stream file used by generate and replay modes (default: operations.bin)");
 
     boost::program_options::options_description visible("Allowed options");
     visible.add(generalSettings);
@@ -94,7 +98,20 @@ void CliImporter::overrideProperties() {
                 "Default value used.";
         }
     }
-
+    if(m_vm.count("mode")) {
+        std::string modeString = m_vm["mode"].as<std::string>();
+        if(modeString == "run" || modeString == "generate" || modeString == "replay") {
+            std::cout << "Mode is set to: " << modeString << "\n";
+            m_cliConfig->setString("GeneralSettings.mode", modeString);
+        } else {
+            LOG(WARNING) << "Mode " << modeString << " is invalid. Default value used.";
+        }
+    }
+    if(m_vm.count("operationstream")) {
+        std::string streamString = m_vm["operationstream"].as<std::string>();
+        std::cout << "Operation stream is set to: " << streamString << "\n";
+        m_cliConfig->setString("GeneralSettings.operationstream", streamString);
+    }
 }
 
 } // namespace programconfigurations
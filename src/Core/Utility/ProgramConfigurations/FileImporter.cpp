@@ -90,12 +90,27 @@ void FileImporter::loadWorkloadProperties() {
             m_fileConfig->setDouble("WorkloadSettings." + v.first, convert<double>(v.second.data()).value());
         } else if(v.first == "insertproportion") {
             m_fileConfig->setDouble("WorkloadSettings." + v.first, convert<double>(v.second.data()).value());
+        } else if(!v.second.empty()) {
+            loadNestedProperties("WorkloadSettings." + v.first + ".", v.second);
         } else {
             m_fileConfig->setString("WorkloadSettings." + v.first, v.second.data());
         }
     }
 }
 
+void FileImporter::loadNestedProperties(const std::string &prefix,
+                                        const boost::property_tree::ptree &node) {
+    // <table><orders><recordcount>10</recordcount></orders></table> becomes
+    // WorkloadSettings.table.orders.recordcount
+    BOOST_FOREACH( boost::property_tree::ptree::value_type const& v, node ) {
+        if(!v.second.empty()) {
+            loadNestedProperties(prefix + v.first + ".", v.second);
+        } else {
+            m_fileConfig->setString(prefix + v.first, v.second.data());
+        }
+    }
+}
+
 bool FileImporter::setFileDirectory(const std::string &fileDirectoryIn) {
     if(checkIfFile(fileDirectoryIn)) {
         m_fileDirectory = fileDirectoryIn;
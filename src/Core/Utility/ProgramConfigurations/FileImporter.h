@@ -30,6 +30,9 @@ public:
     bool setFileDirectory(const std::string &fileDirectoryIn);
     void loadWorkloadProperties();
 private:
+    /// Store the leaves below node as dotted keys starting with prefix.
+    void loadNestedProperties(const std::string &prefix, const boost::property_tree::ptree &node);
+
     std::string m_fileDirectory;        // member file directory
     std::shared_ptr<MapConfiguration> m_fileConfig;
     std::string m_workloadName;   //name of the workload selected
@@ -37,21 +37,41 @@ inline uint64_t FNVHash64(uint64_t val) {
   return hash;
 }
 
+///
+/// Key hash functions. FNV_HASH gives YCSB compatible keys, MIX_HASH is a
+/// faster multiply-xorshift mixer.
+///
+enum HashFunction {
+  FNV_HASH,
+  MIX_HASH
+};
+
+const uint64_t kMixMultiplier1 = 0xBF58476D1CE4E5B9;
+const uint64_t kMixMultiplier2 = 0x94D049BB133111EB;
+
+///
+/// SplitMix64 finalizer: two multiplies and three xorshifts instead of FNV's
+/// eight dependent byte rounds. It is a bijection, so distinct inputs give
+/// distinct keys.
+///
+inline uint64_t MixHash64(uint64_t val) {
+  val = (val ^ (val >> 30)) * kMixMultiplier1;
+  val = (val ^ (val >> 27)) * kMixMultiplier2;
+  return val ^ (val >> 31);
+}
+
 inline uint64_t Hash(uint64_t val) { return FNVHash64(val); }
 
+inline uint64_t Hash(uint64_t val, HashFunction function) {
+  return function == MIX_HASH ? MixHash64(val) : FNVHash64(val);
+}
+
 inline double RandomDouble(double min = 0.0, double max = 1.0) {
   static std::default_random_engine generator;
   static std::uniform_real_distribution<double> uniform(min, max);
   return uniform(generator);
 }
 
-///
-/// Returns an ASCII code that can be printed to desplay
-///
-inline char RandomPrintChar() {
-  return rand() % 94 + 33;
-}
-
 } // namespace utility
 } // namespace dbtester
 
@@ -0,0 +1,175 @@
+// ValuePool.h
+
+#ifndef _DBBENCHMARK_VALUEPOOL_H_
+#define _DBBENCHMARK_VALUEPOOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "Exception.h"
+
+namespace dbbenchmark {
+namespace utility {
+/**
+*   \brief A block of random bytes that field values are sliced from.
+*   \details Filled once with independent random characters, so stored values have the
+*       entropy of real payloads instead of compressing to nothing. Each thread owns its
+*       own pool (see ThreadLocal()), aligned to a cache line, so handing out a value
+*       needs no lock, no allocation and no RNG call: successive slices start at offsets
+*       that walk the pool with a fixed stride. At() instead takes the slice at a given
+*       position, so pools of the same seed give the same value in every thread and run.
+*       The bytes are printable characters, or any of the 256 byte values for binary payloads.
+*       A compression ratio below 1 makes the values compressible, like db_bench's compression_ratio:
+*       the pool is built from kPieceSize byte pieces, each a run of ratio * kPieceSize random
+*       characters repeated to fill the piece, so LZ-style compressors (LZ4, Snappy, zstd) shrink
+*       values to roughly that fraction of their size.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class ValuePool {
+public:
+  /// Size of each pool in bytes, and so the longest value that can be sliced.
+  static const std::size_t kPoolSize = (1 << 20);
+  static const std::size_t kCacheLineSize = 64;
+  /// Length of the repeating pieces a compressible pool is made of.
+  static const std::size_t kPieceSize = 100;
+
+  /** Allocate and fill a pool.
+  * @param seed Seed of the random fill.
+  * @param compression_ratio Target compressed size / original size, in (0, 1]. 1 is incompressible.
+  * @param binary Fill with all 256 byte values instead of printable characters.
+  * @throw InvalidArgumentException if compression_ratio is out of range.
+  */
+  explicit ValuePool(uint64_t seed, double compression_ratio = 1.0, bool binary = false);
+  ~ValuePool() { std::free(m_data); }
+
+  ValuePool(const ValuePool&) = delete;
+  ValuePool& operator=(const ValuePool&) = delete;
+
+  /** Pool of the calling thread, created on first use and rebuilt if a different
+  * compression ratio or seed is asked for. Printable and binary pools are kept apart.
+  * Slice() starts at a different place in each thread.
+  * @param compression_ratio See the constructor.
+  * @param binary See the constructor.
+  * @param seed See the constructor.
+  */
+  static ValuePool &ThreadLocal(double compression_ratio = 1.0, bool binary = false, uint64_t seed = 0);
+
+  /** Start of the next value. The following length bytes are random printable characters.
+  * @param length Length of the value, at most kPoolSize.
+  * @throw InvalidArgumentException if length exceeds kPoolSize.
+  */
+  const char *Slice(std::size_t length);
+  /** Start of the value at position, which wraps around the pool. Does not move Slice().
+  * @param length Length of the value, at most kPoolSize.
+  * @throw InvalidArgumentException if length exceeds kPoolSize.
+  */
+  const char *At(uint64_t position, std::size_t length) const;
+
+  const char *data() const { return m_data; }
+  double compression_ratio() const { return m_compressionRatio; }
+  bool binary() const { return m_binary; }
+  uint64_t seed() const { return m_seed; }
+
+  /** A seed different from thread to thread and run to run.
+  */
+  static uint64_t RandomSeed() {
+    std::random_device device;
+    return device() ^ std::hash<std::thread::id>()(std::this_thread::get_id());
+  }
+
+private:
+  /// Odd and not a multiple of the cache line, so slices start at varying alignments.
+  static const std::size_t kStride = 4099;
+
+  char *m_data;
+  std::size_t m_cursor;
+  double m_compressionRatio;
+  bool m_binary;
+  uint64_t m_seed;
+};
+
+inline ValuePool::ValuePool(uint64_t seed, double compression_ratio, bool binary) :
+    m_data(nullptr), m_cursor(0), m_compressionRatio(compression_ratio), m_binary(binary), m_seed(seed) {
+  if (!(compression_ratio > 0.0 && compression_ratio <= 1.0)) {
+    throw InvalidArgumentException("Compression ratio must be in (0, 1]: " +
+        std::to_string(compression_ratio));
+  }
+  void *memory = nullptr;
+  if (::posix_memalign(&memory, kCacheLineSize, kPoolSize) != 0) {
+    throw std::bad_alloc();
+  }
+  m_data = static_cast<char *>(memory);
+  // Number of fresh random characters at the start of each piece; the rest of
+  // the piece repeats them. With a ratio of 1 every character is random.
+  std::size_t raw = static_cast<std::size_t>(compression_ratio * kPieceSize + 0.5);
+  if (raw == 0) {
+    raw = 1;
+  }
+  std::mt19937_64 generator(seed);
+  uint64_t bits = 0;
+  std::size_t bits_left = 0;
+  for (std::size_t start = 0; start < kPoolSize; start += kPieceSize) {
+    std::size_t end = (start + kPieceSize < kPoolSize ? start + kPieceSize : kPoolSize);
+    for (std::size_t i = start; i < end; ++i) {
+      if (i - start < raw) {
+        if (bits_left == 0) {
+          bits = generator();
+          bits_left = 8;
+        }
+        // Binary pools take the byte as is, printable ones scale it onto the
+        // 94 printable characters '!'..'~'.
+        m_data[i] = static_cast<char>(binary ? (bits & 0xff) : 33 + (((bits & 0xff) * 94) >> 8));
+        bits >>= 8;
+        --bits_left;
+      } else {
+        m_data[i] = m_data[i - raw];
+      }
+    }
+  }
+}
+
+inline ValuePool &ValuePool::ThreadLocal(double compression_ratio, bool binary, uint64_t seed) {
+  // Built once per thread unless the ratio or seed changes.
+  thread_local std::unique_ptr<ValuePool> pools[2];
+  std::unique_ptr<ValuePool> &pool = pools[binary ? 1 : 0];
+  if (!pool || pool->m_compressionRatio != compression_ratio || pool->m_seed != seed) {
+    pool.reset(new ValuePool(seed, compression_ratio, binary));
+    // Threads share the seed, so they start slicing at different places.
+    pool->m_cursor = std::hash<std::thread::id>()(std::this_thread::get_id()) % kPoolSize;
+  }
+  return *pool;
+}
+
+inline const char *ValuePool::Slice(std::size_t length) {
+  if (length > kPoolSize) {
+    throw InvalidArgumentException("Value is longer than the value pool: " + std::to_string(length));
+  }
+  m_cursor += kStride;
+  if (m_cursor >= kPoolSize) {
+    m_cursor -= kPoolSize;
+  }
+  std::size_t room = kPoolSize - length + 1;
+  return m_data + (m_cursor < room ? m_cursor : m_cursor % room);
+}
+
+inline const char *ValuePool::At(uint64_t position, std::size_t length) const {
+  if (length > kPoolSize) {
+    throw InvalidArgumentException("Value is longer than the value pool: " + std::to_string(length));
+  }
+  return m_data + position % (kPoolSize - length + 1);
+}
+
+} // namespace utility
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_VALUEPOOL_H_
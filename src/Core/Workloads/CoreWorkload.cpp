@@ -1,5 +1,7 @@
 // CoreWorkload.cpp
 
+#include <charconv>
+#include <sstream>
 #include <string>
 
 #include "CoreWorkload.h"
@@ -9,6 +11,13 @@
 #include "Core/Generators/ScrambledZipfianGenerator.h"
 #include "Core/Generators/SkewedLatestGenerator.h"
 #include "Core/Generators/ConstGenerator.h"
+#include "Core/Generators/HotspotGenerator.h"
+#include "Core/Generators/SequentialGenerator.h"
+#include "Core/Generators/ExponentialGenerator.h"
+#include "Core/Generators/EmpiricalGenerator.h"
+#include "Core/Generators/DriftingGenerator.h"
+#include "Core/Utility/ValuePool.h"
+#include "Core/Utility/PayloadPool.h"
 
 using std::string;
 
@@ -24,10 +33,21 @@ const string CoreWorkload::TABLENAME_PROPERTY =
     WORKLOAD_KEY + "table";
 const string CoreWorkload::TABLENAME_DEFAULT = "usertable";
 
+const string CoreWorkload::TABLES_PROPERTY =
+    WORKLOAD_KEY + "tables";
+
+const string CoreWorkload::TABLE_WEIGHT_PROPERTY =
+    WORKLOAD_KEY + "weight";
+const double CoreWorkload::TABLE_WEIGHT_DEFAULT = 1.0;
+
 const string CoreWorkload::FIELD_COUNT_PROPERTY = 
     WORKLOAD_KEY + "fieldcount";
 const int CoreWorkload::FIELD_COUNT_DEFAULT = 10;
 
+const string CoreWorkload::FIELD_NAME_PREFIX_PROPERTY =
+    WORKLOAD_KEY + "fieldnameprefix";
+const string CoreWorkload::FIELD_NAME_PREFIX_DEFAULT = "field";
+
 const string CoreWorkload::FIELD_LENGTH_DISTRIBUTION_PROPERTY =
     WORKLOAD_KEY + "field_len_dist";
 const string CoreWorkload::FIELD_LENGTH_DISTRIBUTION_DEFAULT = 
@@ -37,6 +57,18 @@ const string CoreWorkload::FIELD_LENGTH_PROPERTY =
     WORKLOAD_KEY + "fieldlength";
 const int CoreWorkload::FIELD_LENGTH_DEFAULT = 100;
 
+const string CoreWorkload::COMPRESSION_RATIO_PROPERTY =
+    WORKLOAD_KEY + "compressionratio";
+const double CoreWorkload::COMPRESSION_RATIO_DEFAULT = 1.0;
+
+const string CoreWorkload::PAYLOAD_TYPE_PROPERTY =
+    WORKLOAD_KEY + "payloadtype";
+const string CoreWorkload::PAYLOAD_TYPE_DEFAULT = "ascii";
+
+const string CoreWorkload::DATA_INTEGRITY_PROPERTY =
+    WORKLOAD_KEY + "dataintegrity";
+const bool CoreWorkload::DATA_INTEGRITY_DEFAULT = false;
+
 const string CoreWorkload::READ_ALL_FIELDS_PROPERTY = 
     WORKLOAD_KEY + "readallfields";
 const bool CoreWorkload::READ_ALL_FIELDS_DEFAULT = true;
@@ -65,10 +97,59 @@ const string CoreWorkload::READMODIFYWRITE_PROPORTION_PROPERTY =
     WORKLOAD_KEY + "readmodifywriteproportion";
 const double CoreWorkload::READMODIFYWRITE_PROPORTION_DEFAULT = 0.0;
 
+const string CoreWorkload::DELETE_PROPORTION_PROPERTY =
+    WORKLOAD_KEY + "deleteproportion";
+const double CoreWorkload::DELETE_PROPORTION_DEFAULT = 0.0;
+
+const string CoreWorkload::CHURN_PROPERTY =
+    WORKLOAD_KEY + "churn";
+const bool CoreWorkload::CHURN_DEFAULT = false;
+
+const string CoreWorkload::BATCH_SIZE_PROPERTY =
+    WORKLOAD_KEY + "batchsize";
+const int CoreWorkload::BATCH_SIZE_DEFAULT = 1;
+
 const string CoreWorkload::REQUEST_DISTRIBUTION_PROPERTY =
     WORKLOAD_KEY + "requestdistribution";
 const string CoreWorkload::REQUEST_DISTRIBUTION_DEFAULT = "uniform";
 
+const string CoreWorkload::HOTSPOT_DATA_FRACTION_PROPERTY =
+    WORKLOAD_KEY + "hotspotdatafraction";
+const double CoreWorkload::HOTSPOT_DATA_FRACTION_DEFAULT = 0.2;
+
+const string CoreWorkload::HOTSPOT_OPN_FRACTION_PROPERTY =
+    WORKLOAD_KEY + "hotspotopnfraction";
+const double CoreWorkload::HOTSPOT_OPN_FRACTION_DEFAULT = 0.8;
+
+const string CoreWorkload::EXPONENTIAL_PERCENTILE_PROPERTY =
+    WORKLOAD_KEY + "exponential.percentile";
+const double CoreWorkload::EXPONENTIAL_PERCENTILE_DEFAULT =
+    ExponentialGenerator::kExponentialPercentile;
+
+const string CoreWorkload::EXPONENTIAL_FRAC_PROPERTY =
+    WORKLOAD_KEY + "exponential.frac";
+const double CoreWorkload::EXPONENTIAL_FRAC_DEFAULT =
+    ExponentialGenerator::kExponentialFrac;
+
+const string CoreWorkload::EMPIRICAL_FILE_PROPERTY =
+    WORKLOAD_KEY + "empiricalfile";
+
+const string CoreWorkload::DRIFT_DISTRIBUTION_PROPERTY =
+    WORKLOAD_KEY + "drift.distribution";
+const string CoreWorkload::DRIFT_DISTRIBUTION_DEFAULT = "zipfian";
+
+const string CoreWorkload::DRIFT_MODE_PROPERTY =
+    WORKLOAD_KEY + "drift.mode";
+const string CoreWorkload::DRIFT_MODE_DEFAULT = "step";
+
+const string CoreWorkload::DRIFT_INTERVAL_PROPERTY =
+    WORKLOAD_KEY + "drift.interval";
+const unsigned int CoreWorkload::DRIFT_INTERVAL_DEFAULT = 100000;
+
+const string CoreWorkload::DRIFT_FRACTION_PROPERTY =
+    WORKLOAD_KEY + "drift.fraction";
+const double CoreWorkload::DRIFT_FRACTION_DEFAULT = 0.1;
+
 const string CoreWorkload::MAX_SCAN_LENGTH_PROPERTY = 
     WORKLOAD_KEY + "maxscanlength";
 const int CoreWorkload::MAX_SCAN_LENGTH_DEFAULT = 1000;
@@ -83,6 +164,19 @@ const string CoreWorkload::INSERT_ORDER_PROPERTY =
 const string CoreWorkload::INSERT_ORDER_DEFAULT = 
     "hashed";
 
+const string CoreWorkload::KEY_HASH_PROPERTY =
+    WORKLOAD_KEY + "keyhash";
+const string CoreWorkload::KEY_HASH_DEFAULT =
+    "fnv";
+
+const string CoreWorkload::ZERO_PADDING_PROPERTY =
+    WORKLOAD_KEY + "zeropadding";
+const int CoreWorkload::ZERO_PADDING_DEFAULT = 1;
+
+const string CoreWorkload::KEY_PREFIX_PROPERTY =
+    WORKLOAD_KEY + "keyprefix";
+const string CoreWorkload::KEY_PREFIX_DEFAULT = "user";
+
 const string CoreWorkload::INSERT_START_PROPERTY = 
     WORKLOAD_KEY + "insertstart";
 const int CoreWorkload::INSERT_START_DEFAULT = 0;
@@ -92,12 +186,68 @@ const string CoreWorkload::RECORD_COUNT_PROPERTY =
 const string CoreWorkload::OPERATION_COUNT_PROPERTY = 
     WORKLOAD_KEY + "operationcount";
 
+// Instance ids start at 1, so a thread without key rings never matches.
+std::atomic<uint64_t> CoreWorkload::instanceCount(0);
+thread_local uint64_t CoreWorkload::keyRingsOwner = 0;
+thread_local std::vector<CoreWorkload::KeyRing> CoreWorkload::keyRings;
+thread_local uint64_t CoreWorkload::writerOwner = 0;
+thread_local uint64_t CoreWorkload::writerId = 0;
+thread_local uint64_t CoreWorkload::writerSequence = 0;
+
+string CoreWorkload::TableProperty(const string &table, const string &property) {
+  return WORKLOAD_KEY + "table." + table + "." + property.substr(WORKLOAD_KEY.size());
+}
+
 void CoreWorkload::Init() {
-  m_tableName = m_localConf->getString(TABLENAME_PROPERTY,TABLENAME_DEFAULT);
+  // Key rings drawn from an earlier Init() belong to choosers that are gone.
+  m_instanceId = ++instanceCount;
+  std::vector<string> table_names;
+  std::istringstream table_list(m_localConf->getString(TABLES_PROPERTY, ""));
+  for (string name; std::getline(table_list, name, ',');) {
+    name.erase(0, name.find_first_not_of(" \t\n"));
+    name.erase(name.find_last_not_of(" \t\n") + 1);
+    if (!name.empty()) {
+      table_names.push_back(name);
+    }
+  }
+  if (table_names.empty()) {
+    table_names.push_back(m_localConf->getString(TABLENAME_PROPERTY,TABLENAME_DEFAULT));
+  }
+  if (table_names.size() > MAX_TABLES) {
+    throw InvalidArgumentException("At most " + std::to_string(MAX_TABLES) + " tables are supported");
+  }
   
-  m_fieldCount = m_localConf->getInt(FIELD_COUNT_PROPERTY,
-                                        FIELD_COUNT_DEFAULT);
-  m_fieldLenGenerator = GetFieldLenGenerator();
+  // Field names are interned once; operations only hand out references to them.
+  std::string field_prefix = m_localConf->getString(FIELD_NAME_PREFIX_PROPERTY,
+                                                    FIELD_NAME_PREFIX_DEFAULT);
+  m_fieldNamePrefix = field_prefix;
+  m_compressionRatio = m_localConf->getDouble(COMPRESSION_RATIO_PROPERTY,
+                                              COMPRESSION_RATIO_DEFAULT);
+  if (!(m_compressionRatio > 0.0 && m_compressionRatio <= 1.0)) {
+    throw InvalidArgumentException("compressionratio must be in (0, 1]: " +
+        std::to_string(m_compressionRatio));
+  }
+  std::string payload_type = m_localConf->getString(PAYLOAD_TYPE_PROPERTY, PAYLOAD_TYPE_DEFAULT);
+  if (payload_type == "ascii") {
+    m_payloadType = ASCII_PAYLOAD;
+  } else if (payload_type == "binary") {
+    m_payloadType = BINARY_PAYLOAD;
+  } else if (payload_type == "json") {
+    m_payloadType = JSON_PAYLOAD;
+  } else if (payload_type == "integer") {
+    m_payloadType = INTEGER_PAYLOAD;
+  } else if (payload_type == "uuid") {
+    m_payloadType = UUID_PAYLOAD;
+  } else if (payload_type == "counter") {
+    m_payloadType = COUNTER_PAYLOAD;
+  } else {
+    throw InvalidArgumentException("Unknown payload type: " + payload_type);
+  }
+  m_valueSeed = m_replay ? m_replayValues.seed : ValuePool::RandomSeed();
+  m_dataIntegrity = m_localConf->getBool(DATA_INTEGRITY_PROPERTY, DATA_INTEGRITY_DEFAULT);
+  if (m_dataIntegrity && m_payloadType != ASCII_PAYLOAD && m_payloadType != BINARY_PAYLOAD) {
+    throw InvalidArgumentException("dataintegrity needs ascii or binary payloads: " + payload_type);
+  }
   
   double read_proportion = m_localConf->getDouble(READ_PROPORTION_PROPERTY,
                                                   READ_PROPORTION_DEFAULT);
@@ -109,21 +259,20 @@ void CoreWorkload::Init() {
                                                   SCAN_PROPORTION_DEFAULT);
   double readmodifywrite_proportion = m_localConf->getDouble(
       READMODIFYWRITE_PROPORTION_PROPERTY, READMODIFYWRITE_PROPORTION_DEFAULT);
-  
-  try {
-    m_recordCount = m_localConf->getInt(RECORD_COUNT_PROPERTY);
-  }
-  catch(const std::exception& e) {
-    LOG(INFO) << "[recordcount property must be specified]" << std::endl;
-    throw;
+  double delete_proportion = m_localConf->getDouble(DELETE_PROPORTION_PROPERTY,
+                                                    DELETE_PROPORTION_DEFAULT);
+  m_churn = m_localConf->getBool(CHURN_PROPERTY, CHURN_DEFAULT);
+  int batch_size = m_localConf->getInt(BATCH_SIZE_PROPERTY, BATCH_SIZE_DEFAULT);
+  if (batch_size < 1) {
+    throw InvalidArgumentException("batchsize must be positive: " + std::to_string(batch_size));
   }
-  std::string request_dist = m_localConf->getString(REQUEST_DISTRIBUTION_PROPERTY,
-                                          REQUEST_DISTRIBUTION_DEFAULT);
+  m_batchSize = batch_size;
+  
   int max_scan_len = m_localConf->getInt(MAX_SCAN_LENGTH_PROPERTY,
                                             MAX_SCAN_LENGTH_DEFAULT);
   std::string scan_len_dist = m_localConf->getString(SCAN_LENGTH_DISTRIBUTION_PROPERTY,
                                             SCAN_LENGTH_DISTRIBUTION_DEFAULT);
-  int insert_start = m_localConf->getInt(INSERT_START_PROPERTY,
+  m_insertStart = m_localConf->getInt(INSERT_START_PROPERTY,
                                             INSERT_START_DEFAULT);
   
   m_readAllFields = m_localConf->getBool(READ_ALL_FIELDS_PROPERTY,
@@ -136,8 +285,24 @@ void CoreWorkload::Init() {
   } else {
     m_orderedInserts = true;
   }
+  m_keyPrefix = m_localConf->getString(KEY_PREFIX_PROPERTY, KEY_PREFIX_DEFAULT);
+  int zero_padding = m_localConf->getInt(ZERO_PADDING_PROPERTY, ZERO_PADDING_DEFAULT);
+  if (zero_padding < 1 || !KeyBuffer::Fits(m_keyPrefix.size(), zero_padding)) {
+    throw InvalidArgumentException("keyprefix and zeropadding must fit in " +
+        std::to_string(KeyBuffer::kCapacity) + " bytes");
+  }
+  m_zeroPadding = zero_padding;
+  std::string key_hash = m_localConf->getString(KEY_HASH_PROPERTY, KEY_HASH_DEFAULT);
+  if (key_hash == "fnv") {
+    m_keyHash = utility::FNV_HASH;
+  } else if (key_hash == "mix") {
+    m_keyHash = utility::MIX_HASH;
+  } else {
+    throw InvalidArgumentException("Unknown key hash: " + key_hash);
+  }
   
-  m_keyGenerator = new CounterGenerator(insert_start);
+  // The load phase walks the tables one after another, each from insertstart.
+  m_keyGenerator = new CounterGenerator(0);
   
   if (read_proportion > 0) {
     m_opChooser.AddValue(READ, read_proportion);
@@ -154,46 +319,186 @@ void CoreWorkload::Init() {
   if (readmodifywrite_proportion > 0) {
     m_opChooser.AddValue(READMODIFYWRITE, readmodifywrite_proportion);
   }
+  if (delete_proportion > 0) {
+    m_opChooser.AddValue(DELETE, delete_proportion);
+  }
+  
+  m_tables.clear();
+  m_totalRecordCount = 0;
+  double total_weight = 0;
+  for (const string &name : table_names) {
+    std::unique_ptr<WorkloadTable> table(new WorkloadTable());
+    table->name = name;
+    table->loadOffset = m_totalRecordCount;
+    InitTable(*table, field_prefix, insert_proportion);
+    if (m_replay) {
+      if (m_tables.size() >= m_replayValues.fieldLengths.size() ||
+          m_replayValues.fieldLengths[m_tables.size()].size() != WorkloadTable::kFieldLengthSamples) {
+        throw InvalidArgumentException("The operation stream has no field lengths for table " + name);
+      }
+      table->fieldLengths = m_replayValues.fieldLengths[m_tables.size()];
+    }
+    m_totalRecordCount += table->recordCount;
+    
+    double weight = m_localConf->getDouble(TableProperty(name, TABLE_WEIGHT_PROPERTY),
+                                           TABLE_WEIGHT_DEFAULT);
+    if (weight < 0) {
+      throw InvalidArgumentException("Table weight must not be negative: " + name);
+    }
+    if (weight > 0) {
+      m_tableChooser.AddValue(static_cast<uint32_t>(m_tables.size()), weight);
+      total_weight += weight;
+    }
+    m_tables.push_back(std::move(table));
+  }
+  if (m_tables.size() > 1 && total_weight <= 0) {
+    throw InvalidArgumentException("At least one table needs a positive weight");
+  }
+  
+  if (scan_len_dist == "uniform") {
+    m_scanLenChooser = new UniformGenerator(1, max_scan_len);
+  } else if (scan_len_dist == "zipfian") {
+    m_scanLenChooser = new ZipfianGenerator(1, max_scan_len);
+  } else {
+    throw IllegalStateException("Distribution not allowed for scan length: " +
+        scan_len_dist);
+  }
+}
+
+void CoreWorkload::InitTable(WorkloadTable &table, const string &field_prefix,
+                             double insert_proportion) {
+  const string &name = table.name;
+  table.fieldCount = m_localConf->getInt(TableProperty(name, FIELD_COUNT_PROPERTY),
+      m_localConf->getInt(FIELD_COUNT_PROPERTY, FIELD_COUNT_DEFAULT));
+  if (table.fieldCount < 1) {
+    throw InvalidArgumentException("fieldcount must be positive for table " + name);
+  }
+  table.fieldNames.clear();
+  table.fieldNames.reserve(table.fieldCount);
+  for (int i = 0; i < table.fieldCount; ++i) {
+    table.fieldNames.push_back(field_prefix + std::to_string(i));
+  }
+  table.fieldLenGenerator = GetFieldLenGenerator(name);
+  table.fieldLengths.resize(WorkloadTable::kFieldLengthSamples);
+  for (uint32_t &length : table.fieldLengths) {
+    length = static_cast<uint32_t>(table.fieldLenGenerator->Next());
+  }
+  
+  string record_count_key = TableProperty(name, RECORD_COUNT_PROPERTY);
+  int configured_count = 0;
+  try {
+    configured_count = m_localConf->getInt(m_localConf->has(record_count_key) ?
+                                           record_count_key : RECORD_COUNT_PROPERTY);
+  }
+  catch(const std::exception& e) {
+    LOG(INFO) << "[recordcount property must be specified]" << std::endl;
+    throw;
+  }
+  // Checked before the conversion, so a negative count cannot wrap to a huge keyspace.
+  if (configured_count < 1) {
+    throw InvalidArgumentException("recordcount must be positive for table " + name);
+  }
+  table.recordCount = configured_count;
+  std::size_t record_count = table.recordCount;
+  std::string request_dist = m_localConf->getString(TableProperty(name, REQUEST_DISTRIBUTION_PROPERTY),
+      m_localConf->getString(REQUEST_DISTRIBUTION_PROPERTY, REQUEST_DISTRIBUTION_DEFAULT));
   
-  m_insertKeySequence.Set(m_recordCount);
+  table.insertKeySequence.Set(record_count);
+  // Each client deletes from its own insertstart on, the records it loaded.
+  table.deleteStart = m_insertStart;
+  table.nextDelete.store(m_insertStart);
   
   if (request_dist == "uniform") {
-    m_keyChooser = new UniformGenerator(0, m_recordCount - 1);
+    table.keyChooser = new UniformGenerator(0, record_count - 1);
     
   } else if (request_dist == "zipfian") {
     // If the number of keys changes, we don't want to change popular keys.
     // So we construct the scrambled zipfian generator with a keyspace
     // that is larger than what exists at the beginning of the test.
-    // If the generator picks a key that is not inserted yet, we just ignore it
-    // and pick another key.
+    // If the generator picks a key that is not inserted yet,
+    // NextTransactionKey() draws again.
     int op_count = m_localConf->getInt(OPERATION_COUNT_PROPERTY);
     int new_keys = (int)(op_count * insert_proportion * 2); // a fudge factor
-    m_keyChooser = new ScrambledZipfianGenerator(m_recordCount + new_keys);
+    table.keyChooser = new ScrambledZipfianGenerator(record_count + new_keys, m_keyHash);
     
   } else if (request_dist == "latest") {
-    m_keyChooser = new SkewedLatestGenerator(m_insertKeySequence);
+    table.keyChooser = new SkewedLatestGenerator(table.insertKeySequence);
+    table.keyMapping = WorkloadTable::KEY_NUM;
+    
+  } else if (request_dist == "hotspot") {
+    double hot_set_fraction = m_localConf->getDouble(HOTSPOT_DATA_FRACTION_PROPERTY,
+                                                     HOTSPOT_DATA_FRACTION_DEFAULT);
+    double hot_opn_fraction = m_localConf->getDouble(HOTSPOT_OPN_FRACTION_PROPERTY,
+                                                     HOTSPOT_OPN_FRACTION_DEFAULT);
+    table.keyChooser = new HotspotGenerator(0, record_count - 1,
+                                            hot_set_fraction, hot_opn_fraction);
+    
+  } else if (request_dist == "sequential") {
+    table.keyChooser = new SequentialGenerator(0, record_count - 1);
+    
+  } else if (request_dist == "exponential") {
+    double percentile = m_localConf->getDouble(EXPONENTIAL_PERCENTILE_PROPERTY,
+                                               EXPONENTIAL_PERCENTILE_DEFAULT);
+    double frac = m_localConf->getDouble(EXPONENTIAL_FRAC_PROPERTY,
+                                         EXPONENTIAL_FRAC_DEFAULT);
+    table.keyChooser = new ExponentialGenerator(percentile, record_count * frac);
+    table.keyMapping = WorkloadTable::LATEST_OFFSET;
+    
+  } else if (request_dist == "empirical") {
+    // Histogram keys beyond the inserted range are drawn again by
+    // NextTransactionKey(), so export the histogram over recordcount keys.
+    try {
+      table.keyChooser = new EmpiricalGenerator(m_localConf->getString(EMPIRICAL_FILE_PROPERTY));
+    }
+    catch(const std::exception& e) {
+      LOG(INFO) << "[empiricalfile property must name a valid histogram file]" << std::endl;
+      throw;
+    }
+    
+  } else if (request_dist == "drifting") {
+    // The unscrambled zipfian keeps the hot keys contiguous, so the drift
+    // visibly moves a key range; insertorder=hashed still scatters the keys.
+    std::string drift_dist = m_localConf->getString(DRIFT_DISTRIBUTION_PROPERTY,
+                                                    DRIFT_DISTRIBUTION_DEFAULT);
+    Generator<uint64_t> *hot_chooser = NULL;
+    if (drift_dist == "zipfian") {
+      hot_chooser = new ZipfianGenerator(0, record_count - 1);
+    } else if (drift_dist == "hotspot") {
+      hot_chooser = new HotspotGenerator(0, record_count - 1,
+          m_localConf->getDouble(HOTSPOT_DATA_FRACTION_PROPERTY, HOTSPOT_DATA_FRACTION_DEFAULT),
+          m_localConf->getDouble(HOTSPOT_OPN_FRACTION_PROPERTY, HOTSPOT_OPN_FRACTION_DEFAULT));
+    } else {
+      throw InvalidArgumentException("Distribution not allowed for drifting: " + drift_dist);
+    }
+    std::string drift_mode = m_localConf->getString(DRIFT_MODE_PROPERTY, DRIFT_MODE_DEFAULT);
+    if (drift_mode != "step" && drift_mode != "continuous") {
+      delete hot_chooser;
+      throw InvalidArgumentException("Unknown drift mode: " + drift_mode);
+    }
+    unsigned int drift_interval = m_localConf->getUInt(DRIFT_INTERVAL_PROPERTY,
+                                                      DRIFT_INTERVAL_DEFAULT);
+    double drift_fraction = m_localConf->getDouble(DRIFT_FRACTION_PROPERTY,
+                                                   DRIFT_FRACTION_DEFAULT);
+    table.keyChooser = new DriftingGenerator(hot_chooser, 0, record_count - 1, drift_interval,
+        static_cast<uint64_t>(record_count * drift_fraction),
+        drift_mode == "continuous" ? DriftingGenerator::CONTINUOUS : DriftingGenerator::STEP);
     
   } else {
     throw InvalidArgumentException("Unknown request distribution: " + request_dist);
   }
   
-  m_fieldChooser = new UniformGenerator(0, m_fieldCount - 1);
-  
-  if (scan_len_dist == "uniform") {
-    m_scanLenChooser = new UniformGenerator(1, max_scan_len);
-  } else if (scan_len_dist == "zipfian") {
-    m_scanLenChooser = new ZipfianGenerator(1, max_scan_len);
-  } else {
-    throw IllegalStateException("Distribution not allowed for scan length: " +
-        scan_len_dist);
-  }
+  table.fieldChooser = new UniformGenerator(0, table.fieldCount - 1);
 }
 
-Generator<uint64_t> *CoreWorkload::GetFieldLenGenerator() {
-  string field_len_dist = m_localConf->getString(FIELD_LENGTH_DISTRIBUTION_PROPERTY,
-                                        FIELD_LENGTH_DISTRIBUTION_DEFAULT);
-  int field_len = m_localConf->getInt(FIELD_LENGTH_PROPERTY,
-                                          FIELD_LENGTH_DEFAULT);
+Generator<uint64_t> *CoreWorkload::GetFieldLenGenerator(const string &table) {
+  string field_len_dist = m_localConf->getString(TableProperty(table, FIELD_LENGTH_DISTRIBUTION_PROPERTY),
+      m_localConf->getString(FIELD_LENGTH_DISTRIBUTION_PROPERTY, FIELD_LENGTH_DISTRIBUTION_DEFAULT));
+  int field_len = m_localConf->getInt(TableProperty(table, FIELD_LENGTH_PROPERTY),
+      m_localConf->getInt(FIELD_LENGTH_PROPERTY, FIELD_LENGTH_DEFAULT));
+  if (field_len < 1 || static_cast<std::size_t>(field_len) > ValuePool::kPoolSize) {
+    throw InvalidArgumentException("fieldlength must be between 1 and " +
+        std::to_string(ValuePool::kPoolSize));
+  }
   if(field_len_dist == "constant") {
     return new ConstGenerator(field_len);
   } else if(field_len_dist == "uniform") {
@@ -206,21 +511,223 @@ Generator<uint64_t> *CoreWorkload::GetFieldLenGenerator() {
   }
 }
 
-void CoreWorkload::BuildValues(std::vector<stringPair> &values) {
-  for (int i = 0; i < m_fieldCount; ++i) {
-    stringPair pair;
-    pair.first.append("field").append(std::to_string(i));
-    pair.second.append(m_fieldLenGenerator->Next(), utility::RandomPrintChar());
-    values.push_back(pair);
+FieldValue CoreWorkload::MakeValue(const std::string &field, std::size_t value_len) const {
+  switch (m_payloadType) {
+    case ASCII_PAYLOAD:
+    case BINARY_PAYLOAD: {
+      const char *value = ValuePool::ThreadLocal(m_compressionRatio, m_payloadType == BINARY_PAYLOAD,
+                                                 m_valueSeed).Slice(value_len);
+      return {field, std::string_view(value, value_len), m_payloadType};
+    }
+    default:
+      return {field, PayloadPool::ThreadLocal(m_payloadType, m_valueSeed).Next(), m_payloadType};
+  }
+}
+
+FieldValue CoreWorkload::MakeValue(const std::string &field, std::size_t value_len, uint64_t position) const {
+  switch (m_payloadType) {
+    case ASCII_PAYLOAD:
+    case BINARY_PAYLOAD: {
+      const char *value = ValuePool::ThreadLocal(m_compressionRatio, m_payloadType == BINARY_PAYLOAD,
+                                                 m_valueSeed).At(position, value_len);
+      return {field, std::string_view(value, value_len), m_payloadType};
+    }
+    default:
+      return {field, PayloadPool::ThreadLocal(m_payloadType, m_valueSeed).At(position), m_payloadType};
+  }
+}
+
+ValueSettings CoreWorkload::value_settings() const {
+  ValueSettings values;
+  values.seed = m_valueSeed;
+  for (const std::unique_ptr<WorkloadTable> &table : m_tables) {
+    values.fieldLengths.push_back(table->fieldLengths);
+  }
+  return values;
+}
+
+///
+/// Deterministic values are computed into a per-thread arena. It is reset
+/// whenever a build starts on an empty vector, i.e. for each operation or
+/// load batch, so a batch keeps all its values alive until it is sent.
+///
+static ValueArena &ThreadArena(const std::vector<FieldValue> &values) {
+  thread_local ValueArena arena;
+  if (values.empty()) {
+    arena.Reset();
+  }
+  return arena;
+}
+
+FieldValue CoreWorkload::MakeValue(const WorkloadTable &table, uint64_t field_id, uint64_t key_num,
+                                   uint64_t version, std::size_t value_len, ValueArena &arena,
+                                   const OperationRecord *record) const {
+  if (!m_dataIntegrity) {
+    if (!record) {
+      return MakeValue(table.fieldNames[field_id], value_len);
+    }
+    // Fields of a write sit next to each other in the pools, like its lengths,
+    // so a replay writes the same bytes in any thread. Counters stay in step
+    // with the writes of the thread; other values also move with the key, so
+    // threads writing at the same seed write different values.
+    uint64_t position = record->lengthSeed + field_id;
+    if (m_payloadType != COUNTER_PAYLOAD) {
+      position += utility::MixHash64(record->keyNum);
+    }
+    return MakeValue(table.fieldNames[field_id], value_len, position);
+  }
+  if (value_len < DeterministicValue::kHeaderSize) {
+    value_len = DeterministicValue::kHeaderSize;
+  }
+  char *value = arena.Allocate(value_len);
+  DeterministicValue::Fill(value, value_len, key_num, field_id, version, m_payloadType == BINARY_PAYLOAD);
+  return {table.fieldNames[field_id], std::string_view(value, value_len), m_payloadType};
+}
+
+void CoreWorkload::BuildValues(std::vector<FieldValue> &values, std::size_t table, uint64_t key_num) {
+  const WorkloadTable &state = *m_tables[table];
+  ValueArena &arena = ThreadArena(values);
+  values.reserve(values.size() + state.fieldCount);
+  for (int i = 0; i < state.fieldCount; ++i) {
+    values.push_back(MakeValue(state, i, key_num, 0, state.fieldLenGenerator->Next(), arena));
+  }
+}
+
+uint64_t CoreWorkload::BuildValues(const OperationRecord &record, std::vector<FieldValue> &values) {
+  const WorkloadTable &state = *m_tables[record.table];
+  ValueArena &arena = ThreadArena(values);
+  uint64_t version = NextWriteVersion();
+  values.reserve(values.size() + state.fieldCount);
+  for (int i = 0; i < state.fieldCount; ++i) {
+    values.push_back(MakeValue(state, i, record.keyNum, version,
+                               FieldLength(state, record.lengthSeed, i), arena, &record));
+  }
+  return version;
+}
+
+uint64_t CoreWorkload::BuildUpdate(const OperationRecord &record, std::vector<FieldValue> &update) {
+  ValueArena &arena = ThreadArena(update);
+  uint64_t version = NextWriteVersion();
+  const WorkloadTable &state = *m_tables[record.table];
+  update.push_back(MakeValue(state, record.fieldId, record.keyNum, version,
+                             FieldLength(state, record.lengthSeed, record.fieldId), arena, &record));
+  return version;
+}
+
+bool CoreWorkload::FieldIndex(std::string_view name, std::size_t table, uint64_t &field_id) const {
+  if (name.size() <= m_fieldNamePrefix.size() ||
+      name.compare(0, m_fieldNamePrefix.size(), m_fieldNamePrefix) != 0) {
+    return false;
+  }
+  const char *end = name.data() + name.size();
+  std::from_chars_result parsed = std::from_chars(name.data() + m_fieldNamePrefix.size(), end, field_id);
+  return parsed.ec == std::errc() && parsed.ptr == end &&
+         field_id < static_cast<uint64_t>(m_tables[table]->fieldCount);
+}
+
+///
+/// A read is stale only if it returned an earlier write of the writer of
+/// expected. Versions of different writers say nothing about their order:
+/// another client may have overwritten the key after this one.
+///
+static bool IsStale(uint64_t version, uint64_t expected) {
+  return expected != 0 && DeterministicValue::Writer(version) == DeterministicValue::Writer(expected) &&
+         DeterministicValue::Sequence(version) < DeterministicValue::Sequence(expected);
+}
+
+void CoreWorkload::VerifyRead(const OperationRecord &record, const ReadResult &result,
+                              const WriteVersionCache &written, VerificationCounts &counts) const {
+  const bool binary = (m_payloadType == BINARY_PAYLOAD);
+  for (const stringPair &field : result) {
+    uint64_t field_id;
+    uint64_t version;
+    if (!FieldIndex(field.first, record.table, field_id) ||
+        !DeterministicValue::Verify(field.second, record.keyNum, field_id, binary, version)) {
+      ++counts.corrupt;
+    } else if (IsStale(version, written.Expected(record.table, record.keyNum, field_id))) {
+      ++counts.stale;
+    } else {
+      ++counts.verified;
+    }
+  }
+}
+
+void CoreWorkload::AddVerification(const VerificationCounts &counts) {
+  m_verified.fetch_add(counts.verified);
+  m_stale.fetch_add(counts.stale);
+  m_corrupt.fetch_add(counts.corrupt);
+}
+
+VerificationCounts CoreWorkload::Verification() const {
+  VerificationCounts counts;
+  counts.verified = m_verified.load();
+  counts.stale = m_stale.load();
+  counts.corrupt = m_corrupt.load();
+  return counts;
+}
+
+void CoreWorkload::NextOperationRecord(OperationRecord &record) {
+  std::size_t table = NextTableId();
+  WorkloadTable &state = *m_tables[table];
+  Operation operation;
+  // Under churn a delete owed to an earlier insert of the table goes first.
+  uint64_t pending = state.pendingDeletes.load();
+  while (pending > 0 && !state.pendingDeletes.compare_exchange_weak(pending, pending - 1)) { }
+  if (pending > 0) {
+    operation = DELETE;
+  } else {
+    operation = NextOperation();
+  }
+  if (operation == DELETE && !NextDeleteKeyNum(record.keyNum, table)) {
+    // Never delete the last live record; insert one instead.
+    operation = INSERT;
+  }
+  record.operation = static_cast<uint8_t>(operation);
+  record.table = static_cast<uint8_t>(table);
+  record.fieldId = 0;
+  record.scanLength = 0;
+  record.lengthSeed = 0;
+  record.reserved[0] = record.reserved[1] = 0;
+  switch (operation) {
+    case INSERT:
+      record.keyNum = NextInsertKeyNum(table);
+      record.lengthSeed = NextLengthSeed(state);
+      if (m_churn) {
+        state.pendingDeletes.fetch_add(1);
+      }
+      break;
+    case DELETE:
+      break;
+    case READ:
+      record.keyNum = NextTransactionKeyNum(table);
+      if (!m_readAllFields) {
+        record.fieldId = state.fieldChooser->Next();
+      }
+      break;
+    case SCAN:
+      record.keyNum = NextTransactionKeyNum(table);
+      record.scanLength = NextScanLength();
+      if (!m_readAllFields) {
+        record.fieldId = state.fieldChooser->Next();
+      }
+      break;
+    case UPDATE:
+    case READMODIFYWRITE:
+      record.keyNum = NextTransactionKeyNum(table);
+      if (!m_readAllFields || !m_writeAllFields) {
+        record.fieldId = state.fieldChooser->Next();
+      }
+      record.lengthSeed = NextLengthSeed(state);
+      break;
   }
 }
 
-void CoreWorkload::BuildUpdate(std::vector<stringPair> &update) {
-  stringPair pair;
-  pair.first.append(NextFieldName());
-  pair.second.append(m_fieldLenGenerator->Next(), utility::RandomPrintChar());
-  update.push_back(pair);
+void CoreWorkload::BuildUpdate(std::vector<FieldValue> &update, std::size_t table, uint64_t key_num) {
+  const WorkloadTable &state = *m_tables[table];
+  ValueArena &arena = ThreadArena(update);
+  update.push_back(MakeValue(state, state.fieldChooser->Next(), key_num, NextWriteVersion(),
+                             state.fieldLenGenerator->Next(), arena));
 }
 
 } // namespace workloads
-} // namespace dbbenchmark
\ No newline at end of file
+} // namespace dbbenchmark
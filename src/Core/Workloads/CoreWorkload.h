@@ -3,16 +3,24 @@
 #ifndef _DBBENCHMARK_COREWORKLOAD_H_
 #define _DBBENCHMARK_COREWORKLOAD_H_
 
+#include <atomic>
+#include <memory>
+#include <typeinfo>
 #include <vector>
 #include <string>
 
 #include "Core/Utility/ProgramConfigurations/LayeredConfiguration.h"
 #include "Core/Generators/DiscreteGenerator.h"
 #include "Core/Generators/CounterGenerator.h"
+#include "Core/Generators/AcknowledgedCounterGenerator.h"
 #include "Core/Generators/Generator.h"
+#include "Core/Generators/UniformGenerator.h"
+#include "Core/Utility/DataIntegrity.h"
 #include "Core/Utility/Exception.h"
+#include "Core/Utility/KeyBuffer.h"
 #include "Core/Utility/Utils.h"
 #include "Core/DB.h"
+#include "OperationStream.h"
 
 namespace dbbenchmark {
 namespace workloads {
@@ -22,8 +30,50 @@ enum Operation {
   READ,
   UPDATE,
   SCAN,
-  READMODIFYWRITE
+  READMODIFYWRITE,
+  DELETE
 };
+///
+/// One table of a workload: its records, field layout and key choice. Tables
+/// are created by CoreWorkload::Init() and live as long as the workload.
+///
+struct WorkloadTable {
+  /// Field lengths drawn at Init(); a power of two so a seed wraps with a mask.
+  static const std::size_t kFieldLengthSamples = 1024;
+  /// How a key chooser's value names a record: the rank of a live record, an
+  /// offset back from the latest insert, or the key number itself.
+  enum KeyMapping { LIVE_RANK, LATEST_OFFSET, KEY_NUM };
+
+  WorkloadTable() :
+      fieldCount(0), recordCount(0), loadOffset(0), fieldLenGenerator(NULL), keyChooser(NULL),
+      fieldChooser(NULL), insertKeySequence(3), deleteStart(0), nextDelete(0), pendingDeletes(0),
+      keyMapping(LIVE_RANK) { }
+
+  ~WorkloadTable() {
+    if (fieldLenGenerator) delete fieldLenGenerator;
+    if (keyChooser) delete keyChooser;
+    if (fieldChooser) delete fieldChooser;
+  }
+
+  std::string name;
+  int fieldCount;
+  std::vector<std::string> fieldNames; /// Interned, operations hand out references
+  std::size_t recordCount;
+  std::size_t loadOffset; /// Position of the table's first record in the load sequence
+  dbbenchmark::generators::Generator<uint64_t> *fieldLenGenerator;
+  /// Lengths from fieldLenGenerator that operation records index by their lengthSeed.
+  std::vector<uint32_t> fieldLengths;
+  dbbenchmark::generators::Generator<uint64_t> *keyChooser;
+  dbbenchmark::generators::Generator<uint64_t> *fieldChooser;
+  dbbenchmark::generators::AcknowledgedCounterGenerator insertKeySequence;
+  /// Deletes remove the oldest live record from deleteStart on; keys in
+  /// [deleteStart, nextDelete) are gone.
+  uint64_t deleteStart;
+  std::atomic<uint64_t> nextDelete;
+  std::atomic<uint64_t> pendingDeletes; /// Churn deletes owed to earlier inserts
+  KeyMapping keyMapping;
+};
+
 /**
 *   \brief A trivial integer generator that always returns the same value.
 *   \details The core benchmark scenario. Represents a set of clients doing simple CRUD operations. The
@@ -35,6 +85,14 @@ enum Operation {
       * <LI><b>fieldcount</b>: the number of fields in a record (default: 10)
       * <LI><b>fieldlength</b>: the size of each field (default: 100)
       * <LI><b>minfieldlength</b>: the minimum size of each field (default: 1)
+      * <LI><b>compressionratio</b>: how well generated values compress, as compressed size over
+      * original size in (0, 1]; 1 gives incompressible values (default: 1)
+      * <LI><b>payloadtype</b>: what field values hold: "ascii" (printable characters), "binary" (raw
+      * bytes), "json" (nested documents), "integer", "uuid" or "counter" (integers counting up by one
+      * per value). fieldlength and compressionratio only apply to ascii and binary values (default: ascii)
+      * <LI><b>dataintegrity</b>: make every value a function of its key, field and version and verify
+      * the values reads return, counting verified, stale and corrupt ones. Needs ascii or binary
+      * values; every value is at least 8 bytes long (default: false)
       * <LI><b>readallfields</b>: should reads read all fields (true) or just one (false) (default: true)
       * <LI><b>writeallfields</b>: should updates and read/modify/writes update all fields (true) or just
       * one (false) (default: false)
@@ -44,8 +102,28 @@ enum Operation {
       * <LI><b>scanproportion</b>: what proportion of operations should be scans (default: 0)
       * <LI><b>readmodifywriteproportion</b>: what proportion of operations should be read a record,
       * modify it, write it back (default: 0)
+      * <LI><b>deleteproportion</b>: what proportion of operations should be deletes. A delete removes
+      * the oldest live record from insertstart on and transactions only choose among live records
+      * (default: 0)
+      * <LI><b>batchsize</b>: number of records the load phase writes per DB::batchInsert call; 1
+      * loads one record per insert (default: 1)
+      * <LI><b>churn</b>: pair every insert with a delete of the oldest live record, so the live set
+      * stays at recordcount while the keyspace moves on (default: false)
       * <LI><b>requestdistribution</b>: what distribution should be used to select the records to operate
-      * on - uniform, zipfian, hotspot, sequential, exponential or latest (default: uniform)
+      * on - uniform, zipfian, hotspot, sequential, exponential, empirical, drifting or latest (default: uniform)
+      * <LI><b>hotspotdatafraction</b>: for hotspot, the fraction of the keyspace that is hot (default: 0.2)
+      * <LI><b>hotspotopnfraction</b>: for hotspot, the fraction of operations that hit the hot set (default: 0.8)
+      * <LI><b>exponential.percentile</b>: for exponential, the percentage of operations that fall within
+      * the most recent exponential.frac part of the keyspace (default: 95)
+      * <LI><b>exponential.frac</b>: for exponential, see above (default: 0.8571428571)
+      * <LI><b>empiricalfile</b>: for empirical, the key histogram file to sample from (no default)
+      * <LI><b>drift.distribution</b>: for drifting, the skewed distribution whose hot set moves,
+      * zipfian or hotspot (default: zipfian)
+      * <LI><b>drift.mode</b>: for drifting, whether the hot set jumps at each interval ("step") or
+      * slides steadily ("continuous") (default: step)
+      * <LI><b>drift.interval</b>: for drifting, the number of operations per drift step (default: 100000)
+      * <LI><b>drift.fraction</b>: for drifting, the fraction of the keyspace the hot set moves per
+      * step (default: 0.1)
       * <LI><b>minscanlength</b>: for scans, what is the minimum number of records to scan (default: 1)
       * <LI><b>maxscanlength</b>: for scans, what is the maximum number of records to scan (default: 1000)
       * <LI><b>scanlengthdistribution</b>: for scans, what distribution should be used to choose the
@@ -59,10 +137,21 @@ enum Operation {
       * For example for row 5, with zeropadding=1 you get 'user5' key and with zeropading=8 you get
       * 'user00000005' key. In order to see its impact, zeropadding needs to be bigger than number of
       * digits in the record number.
+      * <LI><b>keyprefix</b>: the prefix of every record key (default: "user")
       * <LI><b>insertorder</b>: should records be inserted in order by key ("ordered"), or in hashed
       * order ("hashed") (default: hashed)
+      * <LI><b>keyhash</b>: hash used for hashed insert order and for scattering zipfian keys: "fnv"
+      * (YCSB compatible keys) or "mix" (a faster multiply-xorshift mixer) (default: fnv)
       * <LI><b>fieldnameprefix</b>: what should be a prefix for field names, the shorter may decrease the
       * required storage size (default: "field")
+      * <LI><b>tables</b>: comma separated list of tables for a multi-table workload; when empty the
+      * workload uses the single table named by <b>table</b> (default: empty)
+      * <LI><b>table.&lt;name&gt;.weight</b>: the relative share of operations that go to table name
+      * (default: 1)
+      * <LI><b>table.&lt;name&gt;.recordcount</b>, <b>table.&lt;name&gt;.fieldcount</b>,
+      * <b>table.&lt;name&gt;.fieldlength</b>, <b>table.&lt;name&gt;.field_len_dist</b> and
+      * <b>table.&lt;name&gt;.requestdistribution</b>: per table overrides of the workload wide
+      * properties. Each table has its own key chooser and insert sequence.
       * </ul>
 *   \author Ozgun AY
 *   \version 1.0
@@ -77,12 +166,31 @@ public:
   ///
   static const std::string TABLENAME_PROPERTY;
   static const std::string TABLENAME_DEFAULT;
+
+  ///
+  /// The name of the property for the comma separated table list of a multi-table workload.
+  ///
+  static const std::string TABLES_PROPERTY;
+
+  ///
+  /// The name of the per table property for the relative share of operations.
+  ///
+  static const std::string TABLE_WEIGHT_PROPERTY;
+  static const double TABLE_WEIGHT_DEFAULT;
+  /// At most this many tables, so a table index fits in an OperationRecord.
+  static const std::size_t MAX_TABLES = 256;
   
   /// 
   /// The name of the property for the number of fields in a record.
   ///
   static const std::string FIELD_COUNT_PROPERTY;
   static const int FIELD_COUNT_DEFAULT;
+
+  ///
+  /// The name of the property for the prefix of every field name.
+  ///
+  static const std::string FIELD_NAME_PREFIX_PROPERTY;
+  static const std::string FIELD_NAME_PREFIX_DEFAULT;
   
   /// 
   /// The name of the property for the field length distribution.
@@ -96,6 +204,24 @@ public:
   ///
   static const std::string FIELD_LENGTH_PROPERTY;
   static const int FIELD_LENGTH_DEFAULT;
+
+  ///
+  /// The name of the property for the target compression ratio of field values.
+  ///
+  static const std::string COMPRESSION_RATIO_PROPERTY;
+  static const double COMPRESSION_RATIO_DEFAULT;
+
+  ///
+  /// The name of the property for the kind of field values: ascii, binary, json, integer or uuid.
+  ///
+  static const std::string PAYLOAD_TYPE_PROPERTY;
+  static const std::string PAYLOAD_TYPE_DEFAULT;
+
+  ///
+  /// The name of the property for deterministic, verifiable field values.
+  ///
+  static const std::string DATA_INTEGRITY_PROPERTY;
+  static const bool DATA_INTEGRITY_DEFAULT;
   
   /// 
   /// The name of the property for deciding whether to read one field (false)
@@ -141,13 +267,89 @@ public:
   ///
   static const std::string READMODIFYWRITE_PROPORTION_PROPERTY;
   static const double READMODIFYWRITE_PROPORTION_DEFAULT;
+
+  ///
+  /// The name of the property for the proportion of delete transactions.
+  ///
+  static const std::string DELETE_PROPORTION_PROPERTY;
+  static const double DELETE_PROPORTION_DEFAULT;
+
+  ///
+  /// The name of the property for churn: every insert is followed by a delete
+  /// of the oldest live record, keeping the live set at a constant size.
+  ///
+  static const std::string CHURN_PROPERTY;
+  static const bool CHURN_DEFAULT;
+
+  ///
+  /// The name of the property for the number of records per batched insert in the load phase.
+  ///
+  static const std::string BATCH_SIZE_PROPERTY;
+  static const int BATCH_SIZE_DEFAULT;
   
   /// 
   /// The name of the property for the the distribution of request keys.
-  /// Options are "uniform", "zipfian" and "latest".
+  /// Options are "uniform", "zipfian", "latest", "hotspot", "sequential",
+  /// "exponential" and "empirical".
   ///
   static const std::string REQUEST_DISTRIBUTION_PROPERTY;
   static const std::string REQUEST_DISTRIBUTION_DEFAULT;
+
+  ///
+  /// Percentage data items that constitute the hot set.
+  ///
+  static const std::string HOTSPOT_DATA_FRACTION_PROPERTY;
+  static const double HOTSPOT_DATA_FRACTION_DEFAULT;
+
+  ///
+  /// Percentage operations that access the hot set.
+  ///
+  static const std::string HOTSPOT_OPN_FRACTION_PROPERTY;
+  static const double HOTSPOT_OPN_FRACTION_DEFAULT;
+
+  ///
+  /// Percentile of the accesses that fall within the most recently
+  /// inserted exponential.frac part of the keyspace.
+  ///
+  static const std::string EXPONENTIAL_PERCENTILE_PROPERTY;
+  static const double EXPONENTIAL_PERCENTILE_DEFAULT;
+
+  ///
+  /// Fraction of the keyspace the exponential percentile applies to.
+  ///
+  static const std::string EXPONENTIAL_FRAC_PROPERTY;
+  static const double EXPONENTIAL_FRAC_DEFAULT;
+
+  ///
+  /// Path of the binary key histogram used by the "empirical" request
+  /// distribution. See EmpiricalGenerator for the file layout.
+  ///
+  static const std::string EMPIRICAL_FILE_PROPERTY;
+
+  ///
+  /// Distribution wrapped by the "drifting" request distribution:
+  /// "zipfian" or "hotspot".
+  ///
+  static const std::string DRIFT_DISTRIBUTION_PROPERTY;
+  static const std::string DRIFT_DISTRIBUTION_DEFAULT;
+
+  ///
+  /// How the drifting hot set moves: "step" or "continuous".
+  ///
+  static const std::string DRIFT_MODE_PROPERTY;
+  static const std::string DRIFT_MODE_DEFAULT;
+
+  ///
+  /// Number of operations per drift step.
+  ///
+  static const std::string DRIFT_INTERVAL_PROPERTY;
+  static const unsigned int DRIFT_INTERVAL_DEFAULT;
+
+  ///
+  /// Fraction of the keyspace the hot set moves per drift step.
+  ///
+  static const std::string DRIFT_FRACTION_PROPERTY;
+  static const double DRIFT_FRACTION_DEFAULT;
   
   /// 
   /// The name of the property for the max scan length (number of records).
@@ -169,6 +371,25 @@ public:
   static const std::string INSERT_ORDER_PROPERTY;
   static const std::string INSERT_ORDER_DEFAULT;
 
+  ///
+  /// The name of the property for the minimum number of digits in a key;
+  /// shorter record numbers are padded with leading zeros.
+  ///
+  static const std::string ZERO_PADDING_PROPERTY;
+  static const int ZERO_PADDING_DEFAULT;
+
+  ///
+  /// The name of the property for the prefix of every record key.
+  ///
+  static const std::string KEY_PREFIX_PROPERTY;
+  static const std::string KEY_PREFIX_DEFAULT;
+
+  ///
+  /// The name of the property for the key hash function: "fnv" or "mix".
+  ///
+  static const std::string KEY_HASH_PROPERTY;
+  static const std::string KEY_HASH_DEFAULT;
+
   static const std::string INSERT_START_PROPERTY;
   static const int INSERT_START_DEFAULT;
   
@@ -181,79 +402,430 @@ public:
   ///
   virtual void Init();
   
-  virtual void BuildValues(std::vector<stringPair> &values);
-  virtual void BuildUpdate(std::vector<stringPair> &update);
+  ///
+  /// The Build* methods append views: field names point into the table's
+  /// field-name table and values into the calling thread's value pools, so
+  /// nothing is copied or allocated beyond the vector itself. With
+  /// dataintegrity the values are computed into a per-thread arena instead;
+  /// they stay valid until the thread builds into an empty vector again.
+  /// key_num only matters for those values. Loaded records have version 0.
+  ///
+  virtual void BuildValues(std::vector<FieldValue> &values, std::size_t table = 0,
+                           uint64_t key_num = 0);
+  virtual void BuildUpdate(std::vector<FieldValue> &update, std::size_t table = 0,
+                           uint64_t key_num = 0);
+  /// Build all fields of the record's table, each with its own FieldLength().
+  /// Returns the version written, 0 without dataintegrity.
+  virtual uint64_t BuildValues(const OperationRecord &record, std::vector<FieldValue> &values);
+  /// Build the single field record.fieldId with a value of FieldLength() bytes.
+  /// Returns the version written, 0 without dataintegrity.
+  virtual uint64_t BuildUpdate(const OperationRecord &record, std::vector<FieldValue> &update);
+  ///
+  /// Check the values a read of record returned against their key, field and
+  /// version. A value the client itself wrote before the version written
+  /// records for the field, i.e. before a write it already completed, counts
+  /// as stale. A value of another writer may be newer and is not.
+  ///
+  void VerifyRead(const OperationRecord &record, const ReadResult &result,
+                  const utility::WriteVersionCache &written, utility::VerificationCounts &counts) const;
+  /// Add a client's verification counts to the workload totals.
+  void AddVerification(const utility::VerificationCounts &counts);
+  utility::VerificationCounts Verification() const;
   
-  virtual std::string NextTable() { return m_tableName; }
+  std::size_t table_count() const { return m_tables.size(); }
+  const std::string &TableName(std::size_t table) const { return m_tables[table]->name; }
+  /// Sum of the record counts of all tables, the size of the load phase.
+  std::size_t TotalRecordCount() const { return m_totalRecordCount; }
+  /// Index of a table chosen by weight.
+  virtual std::size_t NextTableId();
+  virtual const std::string &NextTable() { return TableName(NextTableId()); }
   virtual std::string NextSequenceKey(); /// Used for loading data
+  ///
+  /// Next record of the load phase. The load sequence covers the tables one
+  /// after another; table receives the index of the record's table.
+  ///
+  virtual uint64_t NextSequenceKeyNum(std::size_t &table);
   virtual std::string NextTransactionKey(); /// Used for transactions
+  virtual uint64_t NextTransactionKeyNum(std::size_t table = 0);
+  /// Used for transaction inserts
+  virtual uint64_t NextInsertKeyNum(std::size_t table = 0) { return m_tables[table]->insertKeySequence.Next(); }
+  /// Report a transaction insert as completed, reads may target it from now on.
+  virtual void AcknowledgeInsert(uint64_t key_num, std::size_t table = 0) {
+    m_tables[table]->insertKeySequence.Acknowledge(key_num);
+  }
   virtual Operation NextOperation() { return m_opChooser.Next(); }
-  virtual std::string NextFieldName();
+  ///
+  /// Oldest live record of table, which a delete removes. Returns false, and
+  /// chooses nothing, if that would leave the table without live records.
+  ///
+  virtual bool NextDeleteKeyNum(uint64_t &key_num, std::size_t table = 0);
+  /// Name of a randomly chosen field, an entry of the interned field-name table.
+  virtual const std::string &NextFieldName(std::size_t table = 0);
   virtual std::size_t NextScanLength() { return m_scanLenChooser->Next(); }
+  ///
+  /// Choose everything one transaction needs: the table, the operation, its
+  /// key and, depending on the operation, the field, scan length and value
+  /// length. Values are drawn once per operation, so all written fields share
+  /// one length. The record can be executed right away or stored for replay.
+  ///
+  virtual void NextOperationRecord(OperationRecord &record);
+  ///
+  /// NextOperationRecord() for a workload whose tables all choose keys with a
+  /// KeyChooser. With a final generator class the key draw is a direct call the
+  /// compiler can inline; callers check KeyChoosersAre<KeyChooser>() once first.
+  /// The workload's own choosers are called by qualified name, so this is only
+  /// for BasicClient, which is instantiated for CoreWorkload itself; a subclass
+  /// overriding them goes through NextOperationRecord().
+  ///
+  template <typename KeyChooser>
+  void NextOperationRecordWith(OperationRecord &record);
+  template <typename KeyChooser>
+  uint64_t NextTransactionKeyNumWith(std::size_t table);
+  /// True if the key chooser of every table is exactly a KeyChooser.
+  template <typename KeyChooser>
+  bool KeyChoosersAre() const;
   
+  /// Name of field field_id, valid for the lifetime of the workload.
+  const std::string &FieldName(uint64_t field_id, std::size_t table = 0) const {
+    return m_tables[table]->fieldNames[field_id];
+  }
+  /// Field list naming only field field_id, pointing into the field-name table.
+  FieldList SingleField(uint64_t field_id, std::size_t table = 0) const {
+    return FieldList(&m_tables[table]->fieldNames[field_id], 1);
+  }
+
+  bool churn() const { return m_churn; }
+  bool data_integrity() const { return m_dataIntegrity; }
+  /// Seed of the value pools and each table's field length samples, for a stream of this workload.
+  ValueSettings value_settings() const;
+  ///
+  /// Write the values of a stream generated with values from the next Init()
+  /// on: its seed replaces the random one, its samples the tables' own.
+  ///
+  void SetValueSettings(const ValueSettings &values) {
+    m_replayValues = values;
+    m_replay = true;
+  }
+  std::size_t batch_size() const { return m_batchSize; }
   bool read_all_fields() const { return m_readAllFields; }
   bool write_all_fields() const { return m_writeAllFields; }
 
+  std::string BuildKeyName(uint64_t key_num);
+  ///
+  /// Format the key of record key_num into buffer, without allocating.
+  /// The view is valid until the buffer is reused.
+  ///
+  std::string_view BuildKeyName(uint64_t key_num, utility::KeyBuffer &buffer) const;
+
   CoreWorkload() :
-      m_fieldCount(0), m_readAllFields(false), m_writeAllFields(false),
-      m_fieldLenGenerator(NULL), m_keyGenerator(NULL), m_keyChooser(NULL),
-      m_fieldChooser(NULL), m_scanLenChooser(NULL), m_insertKeySequence(3),
-      m_orderedInserts(true), m_recordCount(0) {
+      m_readAllFields(false), m_writeAllFields(false), m_churn(false), m_batchSize(1), m_dataIntegrity(false),
+      m_writerCount(0), m_valueSeed(0), m_replay(false), m_verified(0), m_stale(0), m_corrupt(0),
+      m_compressionRatio(1.0),
+      m_payloadType(ASCII_PAYLOAD), m_keyGenerator(NULL), m_scanLenChooser(NULL),
+      m_orderedInserts(true), m_keyHash(utility::FNV_HASH),
+      m_keyPrefix("user"), m_zeroPadding(1), m_insertStart(0), m_totalRecordCount(0), m_instanceId(0) {
         m_localConf = &(utility::programconfigurations::LayeredConfiguration::Instance());
   }
   
   virtual ~CoreWorkload() {
-    if (m_fieldLenGenerator) delete m_fieldLenGenerator;
     if (m_keyGenerator) delete m_keyGenerator;
-    if (m_keyChooser) delete m_keyChooser;
-    if (m_fieldChooser) delete m_fieldChooser;
     if (m_scanLenChooser) delete m_scanLenChooser;
   }
   
 protected:
-  dbbenchmark::generators::Generator<uint64_t> *GetFieldLenGenerator();
-  std::string BuildKeyName(uint64_t key_num);
+  /// Scope property to table: WorkloadSettings.x becomes WorkloadSettings.table.<table>.x
+  static std::string TableProperty(const std::string &table, const std::string &property);
+  /// Read the table's properties and build its generators.
+  void InitTable(WorkloadTable &table, const std::string &field_prefix, double insert_proportion);
+  dbbenchmark::generators::Generator<uint64_t> *GetFieldLenGenerator(const std::string &table);
+  /// Next value of the workload's payload type; value_len is used by ascii and binary values.
+  FieldValue MakeValue(const std::string &field, std::size_t value_len) const;
+  /// The value of the workload's payload type at position of the value pools.
+  FieldValue MakeValue(const std::string &field, std::size_t value_len, uint64_t position) const;
+  /// Value of field field_id of table: the next pool value, the one record
+  /// addresses if there is a record, or with dataintegrity the value of
+  /// (key_num, field_id, version) computed into arena.
+  FieldValue MakeValue(const WorkloadTable &table, uint64_t field_id, uint64_t key_num,
+                       uint64_t version, std::size_t value_len, utility::ValueArena &arena,
+                       const OperationRecord *record = NULL) const;
+  ///
+  /// Version of the next transaction write, 0 without dataintegrity: the
+  /// thread's writer id and its next sequence number. A thread takes its id
+  /// once, so writes share no counter.
+  ///
+  uint64_t NextWriteVersion() {
+    if (!m_dataIntegrity) {
+      return 0;
+    }
+    if (writerOwner != m_instanceId) {
+      writerOwner = m_instanceId;
+      writerId = m_writerCount.fetch_add(1) + 1;
+      writerSequence = 0;
+    }
+    return utility::DeterministicValue::Version(writerId, ++writerSequence);
+  }
+  ///
+  /// Seed of the value lengths of a write: field i of the record is
+  /// table.fieldLengths[seed + i], wrapped. Each thread walks the samples in
+  /// order, so successive fields and writes see successive draws.
+  ///
+  static uint32_t NextLengthSeed(const WorkloadTable &table) {
+    thread_local uint32_t cursor = 0;
+    uint32_t seed = cursor;
+    cursor += table.fieldCount;
+    return seed;
+  }
+  static std::size_t FieldLength(const WorkloadTable &table, uint32_t seed, uint64_t field_id) {
+    return table.fieldLengths[(seed + field_id) & (WorkloadTable::kFieldLengthSamples - 1)];
+  }
+  /// Index of a field from its name, false if name is not a field of table.
+  bool FieldIndex(std::string_view name, std::size_t table, uint64_t &field_id) const;
+
+  ///
+  /// Key chooser values one thread drew ahead for one table. Latest keys may
+  /// be up to kSize draws old, which only lags them behind the newest inserts.
+  ///
+  struct KeyRing {
+    static const std::size_t kSize = 64;
+    uint64_t values[kSize];
+    std::size_t next = kSize; /// Index of the next value, kSize when empty
+  };
+  /// The calling thread's key rings, one per table; the first call of a thread sets them up.
+  std::vector<KeyRing> &ThreadKeyRings();
+  /// Chooser values a transaction key draws before it folds one into the live set.
+  static const int kKeyDraws = 16;
+  /// Key of the live record of rank, with deleted records past deleteStart gone.
+  static uint64_t LiveKeyNum(const WorkloadTable &state, uint64_t rank, uint64_t deleted) {
+    return rank < state.deleteStart ? rank : rank + deleted;
+  }
 
-  std::string m_tableName;
-  int m_fieldCount;
+  std::vector<std::unique_ptr<WorkloadTable>> m_tables;
+  dbbenchmark::generators::DiscreteGenerator<uint32_t> m_tableChooser;
   bool m_readAllFields;
   bool m_writeAllFields;
-  dbbenchmark::generators::Generator<uint64_t> *m_fieldLenGenerator;
-  dbbenchmark::generators::Generator<uint64_t> *m_keyGenerator;
+  bool m_churn;
+  std::size_t m_batchSize;
+  bool m_dataIntegrity;
+  std::atomic<uint64_t> m_writerCount; /// Writer ids handed out to threads
+  uint64_t m_valueSeed; /// Seed of the value pools
+  bool m_replay; /// Take the value seed and field lengths from m_replayValues
+  ValueSettings m_replayValues;
+  std::atomic<uint64_t> m_verified;
+  std::atomic<uint64_t> m_stale;
+  std::atomic<uint64_t> m_corrupt;
+  std::string m_fieldNamePrefix;
+  double m_compressionRatio;
+  PayloadType m_payloadType;
+  dbbenchmark::generators::Generator<uint64_t> *m_keyGenerator; /// Position in the load sequence
   dbbenchmark::generators::DiscreteGenerator<Operation> m_opChooser;
-  dbbenchmark::generators::Generator<uint64_t> *m_keyChooser;
-  dbbenchmark::generators::Generator<uint64_t> *m_fieldChooser;
   dbbenchmark::generators::Generator<uint64_t> *m_scanLenChooser;
-  dbbenchmark::generators::CounterGenerator m_insertKeySequence;
   bool m_orderedInserts;
-  std::size_t m_recordCount;
+  utility::HashFunction m_keyHash;
+  std::string m_keyPrefix;
+  std::size_t m_zeroPadding;
+  uint64_t m_insertStart;
+  std::size_t m_totalRecordCount;
+  /// Distinguishes workloads, and each Init() of one, in the per-thread key rings.
+  uint64_t m_instanceId;
+  static std::atomic<uint64_t> instanceCount;
+  static thread_local uint64_t keyRingsOwner;
+  static thread_local std::vector<KeyRing> keyRings;
+  static thread_local uint64_t writerOwner;
+  static thread_local uint64_t writerId;
+  static thread_local uint64_t writerSequence;
 
 private:
   utility::programconfigurations::LayeredConfiguration* m_localConf;
 };
 
 inline std::string CoreWorkload::NextSequenceKey() {
-  uint64_t key_num = m_keyGenerator->Next();
-  return BuildKeyName(key_num);
+  std::size_t table;
+  return BuildKeyName(NextSequenceKeyNum(table));
+}
+
+inline std::size_t CoreWorkload::NextTableId() {
+  return m_tables.size() == 1 ? 0 : m_tableChooser.Next();
+}
+
+inline uint64_t CoreWorkload::NextSequenceKeyNum(std::size_t &table) {
+  uint64_t position = m_keyGenerator->Next();
+  table = m_tables.size() - 1;
+  while (table > 0 && position < m_tables[table]->loadOffset) {
+    --table;
+  }
+  return m_insertStart + position - m_tables[table]->loadOffset;
 }
 
+///
+/// Keys are bounded by the acknowledged insert limit, so a transaction never
+/// targets an insert that is still in flight, and skip the deleted range, so
+/// they do not target a deleted record. Most choosers yield the rank of a
+/// live record: rank r is key r below the deleted range and the key r places
+/// past its start above it, so under churn the choice moves along with the
+/// live set. A value naming no live record (e.g. from the enlarged zipfian
+/// keyspace) is redrawn, which keeps every live record's share of the
+/// distribution; only after kKeyDraws misses in a row, when the chooser can
+/// hardly reach the live set any more, is it folded into it.
+/// Chooser values are taken from the thread's key ring of the table, which
+/// NextBatch() refills KeyRing::kSize values at a time, so the chooser is
+/// called once per refill instead of once per operation.
+///
 inline std::string CoreWorkload::NextTransactionKey() {
-  uint64_t key_num;
+  return BuildKeyName(NextTransactionKeyNum());
+}
+
+inline uint64_t CoreWorkload::NextTransactionKeyNum(std::size_t table) {
+  return NextTransactionKeyNumWith<dbbenchmark::generators::Generator<uint64_t>>(table);
+}
+
+template <typename KeyChooser>
+inline uint64_t CoreWorkload::NextTransactionKeyNumWith(std::size_t table) {
+  WorkloadTable &state = *m_tables[table];
+  // Deletes stay below the limit, so reading it second keeps live positive.
+  uint64_t deleted = state.nextDelete.load() - state.deleteStart;
+  uint64_t limit = state.insertKeySequence.Last();
+  uint64_t live = limit + 1 - deleted;
+  KeyRing &ring = ThreadKeyRings()[table];
+  uint64_t value = 0;
+  for (int draw = 0; draw < kKeyDraws; ++draw) {
+    if (ring.next == KeyRing::kSize) {
+      static_cast<KeyChooser *>(state.keyChooser)->NextBatch(ring.values, KeyRing::kSize);
+      ring.next = 0;
+    }
+    value = ring.values[ring.next++];
+    switch (state.keyMapping) {
+      case WorkloadTable::LIVE_RANK:
+        if (value < live) {
+          return LiveKeyNum(state, value, deleted);
+        }
+        break;
+      case WorkloadTable::LATEST_OFFSET:
+        if (value < live) {
+          return LiveKeyNum(state, live - 1 - value, deleted);
+        }
+        break;
+      case WorkloadTable::KEY_NUM:
+        if (value <= limit && (value < state.deleteStart || value - state.deleteStart >= deleted)) {
+          return value;
+        }
+        break;
+    }
+  }
+  return LiveKeyNum(state, value % live, deleted);
+}
+
+inline std::vector<CoreWorkload::KeyRing> &CoreWorkload::ThreadKeyRings() {
+  if (keyRingsOwner != m_instanceId) {
+    keyRings.assign(m_tables.size(), KeyRing());
+    keyRingsOwner = m_instanceId;
+  }
+  return keyRings;
+}
+
+template <typename KeyChooser>
+inline bool CoreWorkload::KeyChoosersAre() const {
+  for (const std::unique_ptr<WorkloadTable> &table : m_tables) {
+    if (typeid(*table->keyChooser) != typeid(KeyChooser)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+///
+/// The delete counter only moves while it stays below the acknowledged limit,
+/// so concurrent deletes can not pass it and the latest record always lives.
+///
+inline bool CoreWorkload::NextDeleteKeyNum(uint64_t &key_num, std::size_t table) {
+  WorkloadTable &state = *m_tables[table];
+  uint64_t next = state.nextDelete.load();
   do {
-    key_num = m_keyChooser->Next();
-  } while (key_num > m_insertKeySequence.Last());
-  return BuildKeyName(key_num);
+    if (next >= state.insertKeySequence.Last()) {
+      return false;
+    }
+  } while (!state.nextDelete.compare_exchange_weak(next, next + 1));
+  key_num = next;
+  return true;
+}
+
+///
+/// The choosers of the workload itself are called by qualified name, and the
+/// field chooser is always a UniformGenerator, so only KeyChooser decides
+/// whether drawing the key goes through the vtable.
+///
+template <typename KeyChooser>
+inline void CoreWorkload::NextOperationRecordWith(OperationRecord &record) {
+  std::size_t table = CoreWorkload::NextTableId();
+  WorkloadTable &state = *m_tables[table];
+  dbbenchmark::generators::UniformGenerator &field_chooser =
+      *static_cast<dbbenchmark::generators::UniformGenerator *>(state.fieldChooser);
+  Operation operation;
+  // Under churn a delete owed to an earlier insert of the table goes first.
+  uint64_t pending = state.pendingDeletes.load();
+  while (pending > 0 && !state.pendingDeletes.compare_exchange_weak(pending, pending - 1)) { }
+  if (pending > 0) {
+    operation = DELETE;
+  } else {
+    operation = CoreWorkload::NextOperation();
+  }
+  if (operation == DELETE && !CoreWorkload::NextDeleteKeyNum(record.keyNum, table)) {
+    // Never delete the last live record; insert one instead.
+    operation = INSERT;
+  }
+  record.operation = static_cast<uint8_t>(operation);
+  record.table = static_cast<uint8_t>(table);
+  record.fieldId = 0;
+  record.scanLength = 0;
+  record.lengthSeed = 0;
+  record.reserved[0] = record.reserved[1] = 0;
+  switch (operation) {
+    case INSERT:
+      record.keyNum = CoreWorkload::NextInsertKeyNum(table);
+      record.lengthSeed = NextLengthSeed(state);
+      if (m_churn) {
+        state.pendingDeletes.fetch_add(1);
+      }
+      break;
+    case DELETE:
+      break;
+    case READ:
+      record.keyNum = NextTransactionKeyNumWith<KeyChooser>(table);
+      if (!m_readAllFields) {
+        record.fieldId = field_chooser.Next();
+      }
+      break;
+    case SCAN:
+      record.keyNum = NextTransactionKeyNumWith<KeyChooser>(table);
+      record.scanLength = CoreWorkload::NextScanLength();
+      if (!m_readAllFields) {
+        record.fieldId = field_chooser.Next();
+      }
+      break;
+    case UPDATE:
+    case READMODIFYWRITE:
+      record.keyNum = NextTransactionKeyNumWith<KeyChooser>(table);
+      if (!m_readAllFields || !m_writeAllFields) {
+        record.fieldId = field_chooser.Next();
+      }
+      record.lengthSeed = NextLengthSeed(state);
+      break;
+  }
 }
 
 inline std::string CoreWorkload::BuildKeyName(uint64_t key_num) {
+  utility::KeyBuffer buffer;
+  return std::string(BuildKeyName(key_num, buffer));
+}
+
+inline std::string_view CoreWorkload::BuildKeyName(uint64_t key_num, utility::KeyBuffer &buffer) const {
   if (!m_orderedInserts) {
-    key_num = utility::Hash(key_num);
+    key_num = utility::Hash(key_num, m_keyHash);
   }
-  return std::string("user").append(std::to_string(key_num));
+  return buffer.Format(m_keyPrefix, key_num, m_zeroPadding);
 }
 
-inline std::string CoreWorkload::NextFieldName() {
-  return std::string("field").append(std::to_string(m_fieldChooser->Next()));
+inline const std::string &CoreWorkload::NextFieldName(std::size_t table) {
+  return m_tables[table]->fieldNames[m_tables[table]->fieldChooser->Next()];
 }
 
 } // namespace workloads
@@ -0,0 +1,123 @@
+// OperationStream.cpp
+
+#include <cstring>
+
+#include "OperationStream.h"
+
+#include "Core/Utility/Exception.h"
+
+using namespace dbbenchmark::utility;
+
+namespace dbbenchmark {
+namespace workloads {
+
+static const char kOperationStreamMagic[8] = {'D', 'B', 'B', 'O', 'P', 'S', '0', '3'};
+
+///
+/// Bytes of the field length samples, padded so the records stay 8 byte aligned.
+///
+static uint64_t LengthsSize(const OperationStreamHeader &header) {
+  uint64_t size = static_cast<uint64_t>(header.tableCount) * header.lengthCount * sizeof(uint32_t);
+  return (size + 7) & ~static_cast<uint64_t>(7);
+}
+
+OperationStreamWriter::OperationStreamWriter(const std::string &filePath, const ValueSettings &values) :
+    m_filePath(filePath), m_count(0) {
+  std::memset(&m_header, 0, sizeof(m_header));
+  std::memcpy(m_header.magic, kOperationStreamMagic, sizeof(m_header.magic));
+  m_header.recordSize = sizeof(OperationRecord);
+  m_header.tableCount = static_cast<uint32_t>(values.fieldLengths.size());
+  m_header.valueSeed = values.seed;
+  if (!values.fieldLengths.empty()) {
+    m_header.lengthCount = static_cast<uint32_t>(values.fieldLengths[0].size());
+  }
+  for (const std::vector<uint32_t> &lengths : values.fieldLengths) {
+    if (lengths.size() != m_header.lengthCount) {
+      throw InvalidArgumentException("Every table needs the same number of field length samples");
+    }
+  }
+  m_out.open(filePath, std::ios::binary | std::ios::trunc);
+  if (!m_out) {
+    throw FileException("Cannot create operation stream " + filePath);
+  }
+  // Placeholder header, the count is patched in by close().
+  OperationStreamHeader header;
+  std::memset(&header, 0, sizeof(header));
+  m_out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  uint64_t written = 0;
+  for (const std::vector<uint32_t> &lengths : values.fieldLengths) {
+    m_out.write(reinterpret_cast<const char *>(lengths.data()), lengths.size() * sizeof(uint32_t));
+    written += lengths.size() * sizeof(uint32_t);
+  }
+  const char padding[8] = {};
+  m_out.write(padding, LengthsSize(m_header) - written);
+}
+
+OperationStreamWriter::~OperationStreamWriter() {
+  try {
+    close();
+  }
+  catch(...) {
+    // Destructors must not throw; a truncated stream fails validation on read.
+  }
+}
+
+void OperationStreamWriter::write(const OperationRecord &record) {
+  if (!m_out.is_open()) {
+    return;
+  }
+  m_out.write(reinterpret_cast<const char *>(&record), sizeof(record));
+  ++m_count;
+}
+
+void OperationStreamWriter::close() {
+  if (!m_out.is_open()) {
+    return;
+  }
+  m_header.count = m_count;
+  m_out.seekp(0);
+  m_out.write(reinterpret_cast<const char *>(&m_header), sizeof(m_header));
+  bool failed = !m_out;
+  m_out.close();
+  if (failed) {
+    throw FileException("Cannot write operation stream " + m_filePath);
+  }
+}
+
+OperationStreamReader::OperationStreamReader(const std::string &filePath) :
+    m_file(filePath), m_records(nullptr), m_count(0) {
+  if (m_file.size() < sizeof(OperationStreamHeader)) {
+    throw DataException("Operation stream is too short: " + filePath);
+  }
+  OperationStreamHeader header;
+  std::memcpy(&header, m_file.data(), sizeof(header));
+  if (std::memcmp(header.magic, kOperationStreamMagic, sizeof(header.magic)) != 0 ||
+      header.recordSize != sizeof(OperationRecord)) {
+    throw DataException("Not an operation stream: " + filePath);
+  }
+  const uint64_t lengths_size = LengthsSize(header);
+  if (m_file.size() - sizeof(header) < lengths_size ||
+      (m_file.size() - sizeof(header) - lengths_size) / sizeof(OperationRecord) < header.count) {
+    throw DataException("Operation stream is truncated: " + filePath);
+  }
+  m_values.seed = header.valueSeed;
+  m_values.fieldLengths.resize(header.tableCount);
+  const char *lengths = m_file.data() + sizeof(header);
+  for (std::vector<uint32_t> &table_lengths : m_values.fieldLengths) {
+    table_lengths.resize(header.lengthCount);
+    std::memcpy(table_lengths.data(), lengths, header.lengthCount * sizeof(uint32_t));
+    lengths += header.lengthCount * sizeof(uint32_t);
+  }
+  m_count = header.count;
+  m_records = reinterpret_cast<const OperationRecord *>(m_file.data() + sizeof(header) + lengths_size);
+  m_file.adviseSequential();
+}
+
+const OperationRecord *OperationStreamReader::partition(std::size_t index, std::size_t numPartitions,
+                                                        std::size_t &count) const {
+  count = static_cast<std::size_t>(index < m_count ? (m_count - index - 1) / numPartitions + 1 : 0);
+  return m_records + index;
+}
+
+} // namespace workloads
+} // namespace dbbenchmark
@@ -0,0 +1,137 @@
+// OperationStream.h
+
+#ifndef _DBBENCHMARK_OPERATIONSTREAM_H_
+#define _DBBENCHMARK_OPERATIONSTREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Core/Utility/MappedFile.h"
+
+namespace dbbenchmark {
+namespace workloads {
+
+///
+/// One pre-generated transaction. Only the members the operation needs are
+/// meaningful: fieldId when a single field is read or written, scanLength for
+/// scans and lengthSeed for operations that write values.
+///
+struct OperationRecord {
+  uint64_t keyNum;       /// Record number, before insertorder hashing
+  uint32_t lengthSeed;   /// Picks the length of each value written, see CoreWorkload::FieldLength()
+  uint32_t scanLength;   /// Number of records to scan
+  uint32_t fieldId;      /// Index of the single field to read or write
+  uint8_t operation;     /// workloads::Operation
+  uint8_t table;         /// Index of the table in the workload's table list
+  uint8_t reserved[2];
+};
+static_assert(sizeof(OperationRecord) == 24, "OperationRecord is a file format");
+
+///
+/// What a replay needs besides the records to write the same bytes the
+/// generating workload would have: the seed of its value pools and each
+/// table's field length samples, which OperationRecord::lengthSeed indexes.
+///
+struct ValueSettings {
+  uint64_t seed = 0;
+  std::vector<std::vector<uint32_t>> fieldLengths; /// One sample vector per table
+};
+
+///
+/// Header of an operation stream file. All values are in host byte order. The
+/// field length samples follow it, table after table, padded to 8 bytes, and
+/// then the records.
+///
+struct OperationStreamHeader {
+  char magic[8];         /// "DBBOPS03"
+  uint32_t recordSize;   /// sizeof(OperationRecord)
+  uint32_t tableCount;   /// Number of tables with field length samples
+  uint64_t count;        /// Number of records
+  uint64_t valueSeed;    /// ValueSettings::seed
+  uint32_t lengthCount;  /// Field length samples per table
+  uint32_t reserved;
+};
+static_assert(sizeof(OperationStreamHeader) == 40, "OperationStreamHeader is a file format");
+
+/**
+*   \brief Writes OperationRecords to a binary operation stream file.
+*   \details The record count in the header is filled in by close(), which the destructor
+*       also calls.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class OperationStreamWriter {
+public:
+  /** Create (or truncate) an operation stream file.
+  * @param filePath Path of the file.
+  * @param values Seed and field length samples of the workload the records come from.
+  * @throw FileException if the file cannot be created, InvalidArgumentException if the
+  *     tables of values have different numbers of samples.
+  */
+  explicit OperationStreamWriter(const std::string &filePath, const ValueSettings &values = ValueSettings());
+  ~OperationStreamWriter();
+
+  void write(const OperationRecord &record);
+  /** Finish the header and close the file. Further writes are ignored.
+  * @throw FileException if the file could not be written.
+  */
+  void close();
+
+  uint64_t count() const { return m_count; }
+
+private:
+  std::string m_filePath;
+  std::ofstream m_out;
+  uint64_t m_count;
+  OperationStreamHeader m_header; /// Written again by close(), with the count
+};
+
+/**
+*   \brief Memory maps an operation stream file for replay.
+*   \details Records are used in place, so replay performs no generation and no copying.
+*       partition() deals the stream out to the threads round-robin.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class OperationStreamReader {
+public:
+  /** Map an operation stream file.
+  * @param filePath Path of the file.
+  * @throw FileException if the file cannot be mapped, DataException if it is malformed.
+  */
+  explicit OperationStreamReader(const std::string &filePath);
+
+  const OperationRecord *records() const { return m_records; }
+  uint64_t size() const { return m_count; }
+  /// Seed and field length samples the stream was generated with.
+  const ValueSettings &values() const { return m_values; }
+  /** Share of the stream for one of numPartitions threads: records index,
+  * index + numPartitions, index + 2 * numPartitions and so on. Every thread
+  * keeps the generation order and all of them move through the stream
+  * together, so a read rarely runs before the insert of its key; one that
+  * does finds nothing and fails.
+  * @param index Partition index in [0, numPartitions).
+  * @param numPartitions Number of partitions, and the stride between the records of one.
+  * @param count Set to the number of records in the partition.
+  * @return First record of the partition.
+  */
+  const OperationRecord *partition(std::size_t index, std::size_t numPartitions, std::size_t &count) const;
+
+private:
+  utility::MappedFile m_file;
+  const OperationRecord *m_records;
+  uint64_t m_count;
+  ValueSettings m_values;
+};
+
+} // namespace workloads
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_OPERATIONSTREAM_H_
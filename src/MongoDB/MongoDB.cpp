@@ -53,20 +53,59 @@ MongoDB::~MongoDB() {
     delete db;
 }
 
-Status MongoDB::read(const std::string &table, const std::string &key, 
-                        const std::vector<std::string> &fields, std::vector<stringPair> &result) {
+template <typename Builder>
+void MongoDB::appendValue(Builder &builder, const FieldValue &v) {
+    switch (v.type) {
+        case BINARY_PAYLOAD:
+            builder.append(kvp(toStdx(v.field), bsoncxx::types::b_binary{bsoncxx::binary_sub_type::k_binary,
+                static_cast<uint32_t>(v.value.size()), reinterpret_cast<const uint8_t *>(v.value.data())}));
+            break;
+        case JSON_PAYLOAD: {
+            // Parsing the document on every write is the serialization cost a
+            // typed document store pays, so it is part of the measurement.
+            bsoncxx::document::value document = bsoncxx::from_json(toStdx(v.value));
+            builder.append(kvp(toStdx(v.field), bsoncxx::types::b_document{document.view()}));
+            break;
+        }
+        case INTEGER_PAYLOAD:
+        case COUNTER_PAYLOAD: {
+            int64_t number = 0;
+            std::from_chars(v.value.data(), v.value.data() + v.value.size(), number);
+            builder.append(kvp(toStdx(v.field), bsoncxx::types::b_int64{number}));
+            break;
+        }
+        default:
+            builder.append(kvp(toStdx(v.field), toStdx(v.value)));
+            break;
+    }
+}
+
+std::string MongoDB::valueToString(const bsoncxx::document::element &ele) {
+    switch (ele.type()) {
+        case bsoncxx::type::k_binary: {
+            bsoncxx::types::b_binary binary = ele.get_binary();
+            return std::string(reinterpret_cast<const char *>(binary.bytes), binary.size);
+        }
+        case bsoncxx::type::k_document:
+            return bsoncxx::to_json(ele.get_document().view());
+        case bsoncxx::type::k_int64:
+            return std::to_string(ele.get_int64().value);
+        default:
+            return ele.get_utf8().value.to_string();
+    }
+}
+
+Status MongoDB::read(const std::string &table, std::string_view key, 
+                        FieldList fields, ReadResult &result) {
     if (fields.empty()) {
-        auto cursor = (*db)[table].find(make_document(kvp("_id", key)));
+        auto cursor = (*db)[table].find(make_document(kvp("_id", toStdx(key))));
         for (auto &&doc : cursor) {
             for (bsoncxx::document::element ele : doc) {
                 // element is non owning view of a key-value pair within a document.
                 // we can use the key() method to get a string_view of the key.
-                std::string field_key{ele.key()};
-                bsoncxx::types::value ele_val{ele.get_value()};
-                std::string temp_first = field_key;
-                std::string temp_second = ele_val.get_utf8().value.to_string();
-                stringPair stringPairTemp = std::make_pair(temp_first, temp_second);
-                result.push_back(stringPairTemp);
+                stringPair &field = result.emplace_back();
+                field.first.assign(ele.key().data(), ele.key().size());
+                field.second = valueToString(ele);
             }
         }
     }
@@ -75,7 +114,7 @@ Status MongoDB::read(const std::string &table, const std::string &key,
         for(auto it = fields.begin(); it != fields.end(); ++it) {
             document.append(kvp(*it, 1));  // string literal value will be converted to b_utf8 automatically
         }
-        auto cursor = (*db)[table].find(make_document(kvp("_id", key)),
+        auto cursor = (*db)[table].find(make_document(kvp("_id", toStdx(key))),
                                     mongocxx::options::find{}.projection(document.view()));
         for (auto &&doc : cursor) {
             nlohmann::json j = bsoncxx::to_json(doc);
@@ -83,20 +122,17 @@ Status MongoDB::read(const std::string &table, const std::string &key,
             for (bsoncxx::document::element ele : doc) {
                 // element is non owning view of a key-value pair within a document.
                 // we can use the key() method to get a string_view of the key.
-                std::string field_key{ele.key()};
-                bsoncxx::types::value ele_val{ele.get_value()};
-                std::string temp_first = field_key;
-                std::string temp_second = ele_val.get_utf8().value.to_string();
-                stringPair stringPairTemp = std::make_pair(temp_first, temp_second);
-                result.push_back(stringPairTemp);
+                stringPair &field = result.emplace_back();
+                field.first.assign(ele.key().data(), ele.key().size());
+                field.second = valueToString(ele);
             }
         }
     }
     return result.empty() ? Status::ERROR : Status::OK;  
 }
 
-Status MongoDB::scan(const std::string &table, const std::string &startkey, int recordcount, 
-                        std::vector<std::string> &fields, std::vector<std::vector<stringPair>> &result) {
+Status MongoDB::scan(const std::string &table, std::string_view startkey, int recordcount, 
+                        FieldList fields, ScanResult &result) {
     // To-DO
     // Set<String> keys = cmdHash->result_status(INDEX_KEY, hash(startkey),
     // Double.POSITIVE_INFINITY, 0, recordcount);
@@ -110,22 +146,19 @@ Status MongoDB::scan(const std::string &table, const std::string &startkey, int
     return Status::FORBIDDEN;
 }
 
-Status MongoDB::update(const std::string &table, const std::string &key, 
-                        std::vector<stringPair> values) {
+Status MongoDB::update(const std::string &table, std::string_view key, 
+                        RecordView values) {
+    // All fields go into a single $set; the builder copies the views straight
+    // into the BSON buffer.
     auto document = bsoncxx::builder::basic::document{};
-
-    std::vector<stringPair>::iterator it;
-    std::string tempkey;
-    std::string tempvalue;
-
-    for(it = values.begin(); it != values.end(); ++it){
-        tempkey = it->first;
-        tempvalue = it->second;
-        document.append(kvp("$set", make_document(kvp(tempkey, tempvalue))));
-    }
+    document.append(kvp("$set", [values](bsoncxx::builder::basic::sub_document fields) {
+        for (const FieldValue &v : values) {
+            appendValue(fields, v);
+        }
+    }));
 
     bsoncxx::stdx::optional<mongocxx::result::update> result = (*db)[table].update_one(
-                        make_document(kvp("_id", key)),
+                        make_document(kvp("_id", toStdx(key))),
                         document.view());
     if(result) {
         return Status::OK;
@@ -135,17 +168,12 @@ Status MongoDB::update(const std::string &table, const std::string &key,
     }
 
 }
-Status MongoDB::insert(const std::string &table, const std::string &key, 
-                        std::vector<stringPair> &values) {
+Status MongoDB::insert(const std::string &table, std::string_view key, 
+                        RecordView values) {
     auto document = bsoncxx::builder::basic::document{};
-    std::vector<stringPair>::iterator it;
-    document.append(kvp("_id", key));
-    std::string tempKey, tempValue;
-
-    for(it = values.begin(); it != values.end(); ++it){
-        tempKey = it->first;
-        tempValue = it->second;
-        document.append(kvp(tempKey, tempValue));
+    document.append(kvp("_id", toStdx(key)));
+    for (const FieldValue &v : values) {
+        appendValue(document, v);
     }
 
     auto result = (*db)[table].insert_one(document.view());
@@ -157,10 +185,35 @@ Status MongoDB::insert(const std::string &table, const std::string &key,
     }
 }
 
-Status MongoDB::Delete(const std::string &table, const std::string &key) {
+Status MongoDB::batchInsert(const std::string &table, const std::vector<KeyedRecord> &records) {
+    // One insert_many round trip for the whole batch. Unordered, so the server
+    // may apply the documents in parallel and one failure does not stop the rest.
+    std::vector<bsoncxx::document::value> documents;
+    documents.reserve(records.size());
+    for (const KeyedRecord &record : records) {
+        auto document = bsoncxx::builder::basic::document{};
+        document.append(kvp("_id", toStdx(record.key)));
+        for (const FieldValue &v : record.values) {
+            appendValue(document, v);
+        }
+        documents.push_back(document.extract());
+    }
+
+    mongocxx::options::insert options;
+    options.ordered(false);
+    auto result = (*db)[table].insert_many(documents, options);
+    if(result && static_cast<std::size_t>(result->inserted_count()) == records.size()) {
+        return Status::OK;
+    }
+    else {
+        return Status::ERROR;
+    }
+}
+
+Status MongoDB::Delete(const std::string &table, std::string_view key) {
     
     bsoncxx::stdx::optional<mongocxx::result::delete_result> result = 
-                                        (*db)[table].delete_one(make_document(kvp("_id", key)));
+                                        (*db)[table].delete_one(make_document(kvp("_id", toStdx(key))));
     if(result) {
         return Status::OK;
     }
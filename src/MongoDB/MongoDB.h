@@ -3,6 +3,7 @@
 #ifndef _DBBENCHMARK_MONGODB_H_
 #define _DBBENCHMARK_MONGODB_H_
 
+#include <charconv>
 #include <memory>
 #include <iterator> // for iterators 
 #include <vector> // for vectors 
@@ -67,15 +68,16 @@ public:
     };
     void init() override;
     void cleanup() override;
-    Status read(const std::string &table, const std::string &key, 
-                    const std::vector<std::string> &fields, std::vector<stringPair> &result) override;
-    Status scan(const std::string &table, const std::string &startkey, int recordcount, 
-                    std::vector<std::string> &fields, std::vector<std::vector<stringPair>> &result) override;
-    Status update(const std::string &table, const std::string &key, 
-                    std::vector<stringPair> values) override;
-    Status insert(const std::string &table, const std::string &key, 
-                    std::vector<stringPair> &values) override;
-    Status Delete(const std::string &table, const std::string &key) override;
+    Status read(const std::string &table, std::string_view key, 
+                    FieldList fields, ReadResult &result) override;
+    Status scan(const std::string &table, std::string_view startkey, int recordcount, 
+                    FieldList fields, ScanResult &result) override;
+    Status update(const std::string &table, std::string_view key, 
+                    RecordView values) override;
+    Status insert(const std::string &table, std::string_view key, 
+                    RecordView values) override;
+    Status Delete(const std::string &table, std::string_view key) override;
+    Status batchInsert(const std::string &table, const std::vector<KeyedRecord> &records) override;
 
     ~MongoDB();
 protected:
@@ -87,7 +89,25 @@ private:
 * scattered along the whole space of doubles. In a real world scenario one
 * would probably use the ASCII values of the keys.
 */
-    double hash(const std::string &key) { return std::hash<std::string>{}(key); };
+    double hash(std::string_view key) { return std::hash<std::string_view>{}(key); };
+/*
+* bsoncxx has its own string_view, which is not std::string_view unless the
+* driver was built with the C++17 polyfill.
+*/
+    static bsoncxx::stdx::string_view toStdx(std::string_view view) {
+        return bsoncxx::stdx::string_view(view.data(), view.size());
+    }
+/*
+* Append a field with the BSON type of its payload: binary data, an embedded
+* document parsed from JSON, an int64 or a UTF-8 string. Builder is a document
+* or a sub_document builder.
+*/
+    template <typename Builder>
+    static void appendValue(Builder &builder, const FieldValue &v);
+/*
+* Text form of a read field, whatever its BSON type.
+*/
+    static std::string valueToString(const bsoncxx::document::element &ele);
 
     mongocxx::uri *uri;
     mongocxx::client *client;
@@ -0,0 +1,102 @@
+// ClusterSlots.h
+
+#ifndef _DBBENCHMARK_CLUSTERSLOTS_H_
+#define _DBBENCHMARK_CLUSTERSLOTS_H_
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace dbbenchmark {
+namespace redisdb {
+
+/// Number of hash slots a Redis Cluster divides the keys into.
+const std::size_t CLUSTER_SLOTS = 16384;
+
+/**
+*   \brief CRC16 lookup table of the XMODEM polynomial 0x1021, the one Redis Cluster hashes keys with.
+*   \details Built at compile time, so computing a slot costs one table lookup per key byte.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+struct Crc16Table {
+    uint16_t values[256];
+
+    constexpr Crc16Table() : values() {
+        for (unsigned int i = 0; i < 256; ++i) {
+            uint16_t crc = static_cast<uint16_t>(i << 8);
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = static_cast<uint16_t>((crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1));
+            }
+            values[i] = crc;
+        }
+    }
+};
+
+inline constexpr Crc16Table CRC16_TABLE;
+
+inline uint16_t Crc16(std::string_view data) {
+    uint16_t crc = 0;
+    for (unsigned char c : data) {
+        crc = static_cast<uint16_t>((crc << 8) ^ CRC16_TABLE.values[((crc >> 8) ^ c) & 0xFF]);
+    }
+    return crc;
+}
+
+///
+/// Hash slot of a key. Only the part between the first '{' and the next '}'
+/// is hashed if it is not empty, so keys sharing such a tag share a slot.
+///
+inline uint16_t KeySlot(std::string_view key) {
+    std::size_t open = key.find('{');
+    if (open != std::string_view::npos) {
+        std::size_t close = key.find('}', open + 1);
+        if (close != std::string_view::npos && close > open + 1) {
+            key = key.substr(open + 1, close - open - 1);
+        }
+    }
+    return static_cast<uint16_t>(Crc16(key) & (CLUSTER_SLOTS - 1));
+}
+
+///
+/// A MOVED or ASK error: the node at address serves slot from now on, or,
+/// for ASK, only for the command that was redirected.
+///
+struct Redirect {
+    bool ask = false;
+    uint16_t slot = 0;
+    std::string address;
+};
+
+/** Parse the text of an error reply, e.g. "MOVED 3999 127.0.0.1:6381".
+* @return false if the error is not a redirect.
+*/
+inline bool ParseRedirect(std::string_view error, Redirect &redirect) {
+    if (error.compare(0, 6, "MOVED ") == 0) {
+        redirect.ask = false;
+        error.remove_prefix(6);
+    } else if (error.compare(0, 4, "ASK ") == 0) {
+        redirect.ask = true;
+        error.remove_prefix(4);
+    } else {
+        return false;
+    }
+    unsigned int slot = 0;
+    const char *end = error.data() + error.size();
+    const char *digits = std::from_chars(error.data(), end, slot).ptr;
+    if (digits == error.data() || digits == end || *digits != ' ' || slot >= CLUSTER_SLOTS) {
+        return false;
+    }
+    redirect.slot = static_cast<uint16_t>(slot);
+    redirect.address.assign(digits + 1, end);
+    return !redirect.address.empty();
+}
+
+} // namespace redisdb
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_CLUSTERSLOTS_H_
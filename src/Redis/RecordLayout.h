@@ -0,0 +1,411 @@
+// RecordLayout.h
+
+#ifndef _DBBENCHMARK_RECORDLAYOUT_H_
+#define _DBBENCHMARK_RECORDLAYOUT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/Record.h"
+#include "Core/Utility/Utils.h"
+
+namespace dbbenchmark {
+namespace redisdb {
+
+///
+/// How a record is stored: a hash with a field per column, or one string
+/// holding the whole record, packed or as a JSON document.
+///
+enum class Layout : uint8_t { HASH, PACKED, JSON };
+
+/** Layout of its name, "hash", "packed" or "json".
+* @return false for an unknown name.
+*/
+inline bool ParseLayout(std::string_view name, Layout &layout) {
+    if (name == "hash") {
+        layout = Layout::HASH;
+    } else if (name == "packed") {
+        layout = Layout::PACKED;
+    } else if (name == "json") {
+        layout = Layout::JSON;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+///
+/// Separator of the table and the key in the Redis key of a record.
+///
+const char TABLE_SEPARATOR = ':';
+
+/** Replace out with the Redis key of the record key of table, "<table>:<key>", so
+* tables that use the same key names do not overwrite each other's records.
+* @return out, whose buffer is kept for the next key.
+*/
+inline const std::string &RecordKey(const std::string &table, std::string_view key, std::string &out) {
+    out.assign(table);
+    out.push_back(TABLE_SEPARATOR);
+    out.append(key.data(), key.size());
+    return out;
+}
+
+///
+/// True if a read of fields asks for the field name; an empty list asks for all.
+///
+inline bool WantsField(FieldList fields, std::string_view name) {
+    if (fields.empty()) {
+        return true;
+    }
+    for (const std::string &field : fields) {
+        if (field == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+*   \brief Packed layout: the fields of a record, one after the other, in one binary string.
+*   \details Every name and value is its length as a LEB128 varint followed by its bytes, so a
+*       record of ten 100 byte fields costs 20 bytes over its data and any byte may appear in a value.
+*       Decoding skips from length to length and copies only the fields asked for.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class PackedRecord {
+public:
+    /** Replace out with the encoding of values. */
+    static void Encode(RecordView values, std::string &out) {
+        std::size_t size = 0;
+        for (const FieldValue &value : values) {
+            size += 2 * 10 + value.field.size() + value.value.size();
+        }
+        out.clear();
+        out.reserve(size);
+        for (const FieldValue &value : values) {
+            Put(value.field, out);
+            Put(value.value, out);
+        }
+    }
+    /** Append the fields of data that fields asks for to result.
+    * @return false if data is not a packed record.
+    */
+    static bool Decode(std::string_view data, FieldList fields, ReadResult &result) {
+        std::size_t pos = 0;
+        while (pos < data.size()) {
+            std::string_view name, value;
+            if (!Get(data, pos, name) || !Get(data, pos, value)) {
+                return false;
+            }
+            if (WantsField(fields, name)) {
+                utility::stringPair &field = result.emplace_back();
+                field.first.assign(name);
+                field.second.assign(value);
+            }
+        }
+        return true;
+    }
+
+private:
+    static void Put(std::string_view bytes, std::string &out) {
+        std::size_t length = bytes.size();
+        while (length >= 0x80) {
+            out.push_back(static_cast<char>((length & 0x7F) | 0x80));
+            length >>= 7;
+        }
+        out.push_back(static_cast<char>(length));
+        out.append(bytes.data(), bytes.size());
+    }
+    static bool Get(std::string_view data, std::size_t &pos, std::string_view &bytes) {
+        uint64_t length = 0;
+        for (int shift = 0; ; shift += 7) {
+            if (pos == data.size() || shift > 63) {
+                return false;
+            }
+            const uint8_t byte = static_cast<uint8_t>(data[pos++]);
+            length |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (byte < 0x80) {
+                break;
+            }
+        }
+        if (length > data.size() - pos) {
+            return false;
+        }
+        bytes = data.substr(pos, length);
+        pos += length;
+        return true;
+    }
+};
+
+/**
+*   \brief JSON layout: a record as one flat object of string values, {"field0":"...",...}.
+*   \details Quotes, backslashes and control characters are escaped, every other byte is written as
+*       it is, so binary values round-trip but are not valid UTF-8 text. Values of JSON payloads
+*       are stored as strings too, which keeps them byte for byte what was written. Decoding
+*       accepts any flat object of strings, e.g. one re-encoded by Redis' cjson.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+class JsonRecord {
+public:
+    /** Replace out with the document of values. */
+    static void Encode(RecordView values, std::string &out) {
+        std::size_t size = 2;
+        for (const FieldValue &value : values) {
+            size += 6 + value.field.size() + value.value.size();
+        }
+        out.clear();
+        out.reserve(size);
+        out.push_back('{');
+        for (const FieldValue &value : values) {
+            if (out.size() > 1) {
+                out.push_back(',');
+            }
+            Put(value.field, out);
+            out.push_back(':');
+            Put(value.value, out);
+        }
+        out.push_back('}');
+    }
+    /** Append the fields of data that fields asks for to result.
+    * @return false if data is not an object of string values.
+    */
+    static bool Decode(std::string_view data, FieldList fields, ReadResult &result) {
+        std::size_t pos = 0;
+        if (!Expect(data, pos, '{')) {
+            return false;
+        }
+        if (Expect(data, pos, '}')) {
+            return End(data, pos);
+        }
+        std::string name;
+        std::string skipped;
+        for (;;) {
+            if (!Get(data, pos, name) || !Expect(data, pos, ':')) {
+                return false;
+            }
+            if (WantsField(fields, name)) {
+                result.emplace_back().first.assign(name);
+                if (!Get(data, pos, result.back().second)) {
+                    return false;
+                }
+            } else if (!Get(data, pos, skipped)) {
+                return false;
+            }
+            if (Expect(data, pos, '}')) {
+                return End(data, pos);
+            }
+            if (!Expect(data, pos, ',')) {
+                return false;
+            }
+        }
+    }
+
+private:
+    static void Put(std::string_view bytes, std::string &out) {
+        static const char kHex[] = "0123456789abcdef";
+        out.push_back('"');
+        std::size_t plain = 0; // start of the bytes not written yet
+        for (std::size_t i = 0; i < bytes.size(); ++i) {
+            const uint8_t byte = static_cast<uint8_t>(bytes[i]);
+            if (byte >= 0x20 && byte != '"' && byte != '\\' && byte != 0x7F) {
+                continue;
+            }
+            out.append(bytes.data() + plain, i - plain);
+            plain = i + 1;
+            out.push_back('\\');
+            switch (byte) {
+                case '"': out.push_back('"'); break;
+                case '\\': out.push_back('\\'); break;
+                case '\n': out.push_back('n'); break;
+                case '\r': out.push_back('r'); break;
+                case '\t': out.push_back('t'); break;
+                default:
+                    out.append("u00", 3);
+                    out.push_back(kHex[byte >> 4]);
+                    out.push_back(kHex[byte & 0xF]);
+                    break;
+            }
+        }
+        out.append(bytes.data() + plain, bytes.size() - plain);
+        out.push_back('"');
+    }
+    static void Space(std::string_view data, std::size_t &pos) {
+        while (pos < data.size() &&
+               (data[pos] == ' ' || data[pos] == '\n' || data[pos] == '\r' || data[pos] == '\t')) {
+            ++pos;
+        }
+    }
+    /// Skip white space and c if it comes next.
+    static bool Expect(std::string_view data, std::size_t &pos, char c) {
+        Space(data, pos);
+        if (pos < data.size() && data[pos] == c) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+    /// Nothing but white space after the object.
+    static bool End(std::string_view data, std::size_t &pos) {
+        Space(data, pos);
+        return pos == data.size();
+    }
+    static bool Hex4(std::string_view data, std::size_t pos, uint32_t &unit) {
+        if (data.size() - pos < 4) {
+            return false;
+        }
+        unit = 0;
+        for (std::size_t i = pos; i < pos + 4; ++i) {
+            const char c = data[i];
+            unit <<= 4;
+            if (c >= '0' && c <= '9') {
+                unit |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                unit |= c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                unit |= c - 'A' + 10;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+    /// A \u escape, as UTF-8; the ones Put() writes are single bytes below 0x80.
+    static bool Unicode(std::string_view data, std::size_t &pos, std::string &out) {
+        uint32_t code = 0;
+        if (!Hex4(data, pos, code)) {
+            return false;
+        }
+        pos += 4;
+        if (code >= 0xD800 && code < 0xDC00) {
+            uint32_t low = 0;
+            if (data.substr(pos, 2) != "\\u" || !Hex4(data, pos + 2, low) || low < 0xDC00 || low >= 0xE000) {
+                return false;
+            }
+            pos += 6;
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+        if (code < 0x80) {
+            out.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        return true;
+    }
+    /// A string into out, unescaped.
+    static bool Get(std::string_view data, std::size_t &pos, std::string &out) {
+        out.clear();
+        if (!Expect(data, pos, '"')) {
+            return false;
+        }
+        for (;;) {
+            // Copy the run up to the next quote or escape at once.
+            std::size_t special = data.find_first_of("\"\\", pos);
+            if (special == std::string_view::npos || (data[special] == '\\' && special + 1 == data.size())) {
+                return false;
+            }
+            out.append(data.data() + pos, special - pos);
+            pos = special + 1;
+            if (data[special] == '"') {
+                return true;
+            }
+            const char escaped = data[pos++];
+            switch (escaped) {
+                case '"': case '\\': case '/': out.push_back(escaped); break;
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                case 't': out.push_back('\t'); break;
+                case 'u':
+                    if (!Unicode(data, pos, out)) {
+                        return false;
+                    }
+                    break;
+                default:
+                    return false;
+            }
+        }
+    }
+};
+
+///
+/// Lua scripts an update of a string layout runs: they merge the fields of
+/// ARGV[1] into the record at KEYS[1], both encoded in the layout, and SET
+/// the result, so a partial update is one atomic command like an HMSET.
+///
+const char PACKED_MERGE_SCRIPT[] = R"lua(
+local function get(s, i)
+  local length, scale = 0, 1
+  local byte
+  repeat
+    byte = string.byte(s, i)
+    length = length + (byte % 128) * scale
+    scale = scale * 128
+    i = i + 1
+  until byte < 128
+  return string.sub(s, i, i + length - 1), i + length
+end
+local function put(out, s)
+  local length = #s
+  while length >= 128 do
+    out[#out + 1] = string.char(length % 128 + 128)
+    length = math.floor(length / 128)
+  end
+  out[#out + 1] = string.char(length)
+  out[#out + 1] = s
+end
+local names, values = {}, {}
+local function merge(s)
+  local i = 1
+  while i <= #s do
+    local name, value
+    name, i = get(s, i)
+    value, i = get(s, i)
+    if values[name] == nil then
+      names[#names + 1] = name
+    end
+    values[name] = value
+  end
+end
+merge(redis.call('GET', KEYS[1]) or '')
+merge(ARGV[1])
+local out = {}
+for _, name in ipairs(names) do
+  put(out, name)
+  put(out, values[name])
+end
+return redis.call('SET', KEYS[1], table.concat(out))
+)lua";
+
+const char JSON_MERGE_SCRIPT[] = R"lua(
+local record = redis.call('GET', KEYS[1])
+local fields = record and cjson.decode(record) or {}
+for name, value in pairs(cjson.decode(ARGV[1])) do
+  fields[name] = value
+end
+return redis.call('SET', KEYS[1], cjson.encode(fields))
+)lua";
+
+} // namespace redisdb
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_RECORDLAYOUT_H_
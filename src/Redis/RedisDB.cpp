@@ -2,143 +2,859 @@
 
 #include "RedisDB.h"
 
+#include <algorithm>
+
+#include "Core/Utility/Exception.h"
+
 namespace dbbenchmark{
 namespace redisdb {
 
 using namespace dbbenchmark::utility::programconfigurations;
 
+// Instance ids start at 1, so 0 in the cache of a thread means no connection.
+std::atomic<uint64_t> RedisDB::instanceCount(0);
+thread_local uint64_t RedisDB::cachedOwner = 0;
+thread_local RedisDB::Connection *RedisDB::cachedConnection = nullptr;
+
 void RedisDB::init() {
     // PORT
     auto port = m_localConf->getString(PORT_PROPERTY, DEFAULT_PORT);
     // IP
     auto hostIP = m_localConf->getString(HOST_PROPERTY, "192.168.33.10");
-    bool clusterEnabled = m_localConf->getBool(CLUSTER_PROPERTY, false);
+    clusterEnabled = m_localConf->getBool(CLUSTER_PROPERTY, false);
     // Create FULL Redis Address
     auto redisAddr = hostIP + ":" + port;
     // CONN_TIMEOUT
-    int connTimeout = m_localConf->getUInt(CONN_TIMEOUT);
+    connTimeout = m_localConf->getUInt(CONN_TIMEOUT);
     // RW_TIMEOUT
-    int rwTimeout = m_localConf->getUInt(RW_TIMEOUT);
+    rwTimeout = m_localConf->getUInt(RW_TIMEOUT);
     // MAX_CONNS
-    int maxConns = m_localConf->getUInt(MAX_CONNS);
+    maxConns = m_localConf->getUInt(MAX_CONNS, 100);
+    // Password if any given
+    password =  m_localConf->getString(PASSWORD_PROPERTY, "");
 
-    if (clusterEnabled) {
-        // Now create Redis Connection
-        redisClientCluster->set(redisAddr.c_str(), maxConns, connTimeout, rwTimeout);
-        redisClient = new acl::redis_client(redisAddr.c_str(), connTimeout, rwTimeout);
-        redisConnection = std::make_unique<acl::redis_connection>(redisClient);
-
-        cmdHash = std::make_unique<acl::redis_hash>();
-        cmdHash->set_cluster(redisClientCluster, maxConns);
-    } 
-    else {
-        redisClient = new acl::redis_client(redisAddr.c_str(), connTimeout, rwTimeout);
-        redisConnection = std::make_unique<acl::redis_connection>(redisClient);
-        cmdHash = std::make_unique<acl::redis_hash>();
-        cmdHash->set_client(redisClient);
-    }
-    
-    // Set password if any given
-    std::string password =  m_localConf->getString(PASSWORD_PROPERTY, "");
+    // Connections are opened, and authenticated, when a thread first takes one.
+    // In cluster mode this node answers CLUSTER SLOTS, the other nodes get
+    // their pools as the slot map names them.
+    seedHost = hostIP;
+    nodeId(redisAddr);
+
+    // The index is one key per table, so in cluster mode it would live on one node and
+    // every insert would cross to it.
+    depth = m_localConf->getUInt(PIPELINE_PROPERTY, 1);
+    index = m_localConf->getBool(INDEX_PROPERTY, true);
+    if (clusterEnabled && index) {
+        LOG(WARNING) << "Redis scan index is not supported in cluster mode, scans are unavailable";
+        index = false;
+    }
+    if (depth == 0) {
+        depth = 1;
+    }
+    const std::string layoutName = m_localConf->getString(LAYOUT_PROPERTY, "hash");
+    if (!ParseLayout(layoutName, layout)) {
+        std::string message = "Unknown Redis record layout: " + layoutName + ", use hash, packed or json";
+        LOG(WARNING) << message;
+        throw InvalidArgumentException(message);
+    }
+}
+
+std::size_t RedisDB::nodeId(const std::string &address) {
+    std::lock_guard<std::mutex> lock(nodesLock);
+    for (std::size_t id = 0; id < nodeAddresses.size(); ++id) {
+        if (nodeAddresses[id] == address) {
+            return id;
+        }
+    }
+    acl::redis_client_pool *pool = new acl::redis_client_pool(address.c_str(), maxConns);
+    pool->set_timeout(connTimeout, rwTimeout);
     if (!password.empty()) {
-        redisConnection->auth(password.c_str());
+        pool->set_password(password.c_str());
+    }
+    nodeAddresses.push_back(address);
+    nodePools.push_back(pool);
+    return nodePools.size() - 1;
+}
+
+RedisDB::Node &RedisDB::node(Connection &conn, std::size_t id) {
+    if (id >= conn.nodes.size()) {
+        conn.nodes.resize(id + 1);
+    }
+    Node &entry = conn.nodes[id];
+    if (entry.client == nullptr) {
+        acl::redis_client_pool *pool;
+        std::string address;
+        {
+            std::lock_guard<std::mutex> lock(nodesLock);
+            pool = nodePools[id];
+            address = nodeAddresses[id];
+        }
+        entry.client = static_cast<acl::redis_client*>(pool->peek());
+        if (entry.client == nullptr) {
+            std::string message = "No Redis connection left in the pool of " + std::to_string(maxConns) +
+                                  " for " + address + ", raise " + MAX_CONNS + " to the number of threads";
+            LOG(WARNING) << message;
+            throw RuntimeException(message);
+        }
+        entry.pipeline = std::make_unique<RespPipeline>(entry.client);
+        if (layout != Layout::HASH) {
+            loadMergeScript(conn, entry);
+        }
+    }
+    return entry;
+}
+
+void RedisDB::loadMergeScript(Connection &conn, Node &entry) {
+    // Nothing else is queued on a new connection yet, so the reply can be
+    // waited for here. Every node returns the same SHA1 for the script; if
+    // loading fails, updates send the whole script with EVAL instead.
+    RespPipeline &pipeline = *entry.pipeline;
+    pipeline.command(3);
+    pipeline.argument("SCRIPT");
+    pipeline.argument("LOAD");
+    pipeline.argument(mergeScript());
+    RespReply reply;
+    if (!pipeline.send() || !pipeline.read(reply) || !pipeline.skip(reply)) {
+        LOG(WARNING) << "Redis SCRIPT LOAD could not be sent, reconnecting";
+        pipeline.reset();
+    } else if (reply.type == '$' && reply.integer > 0) {
+        conn.mergeSha.assign(reply.text.data(), reply.text.size());
+    } else {
+        LOG(WARNING) << "Redis SCRIPT LOAD failed, updates fall back to EVAL: " << reply.text;
     }
 }
 
+void RedisDB::reloadMergeScript(Connection &conn) {
+    // Between batches nothing is queued on any node, so each one can load it
+    // again right away.
+    conn.scriptMissing = false;
+    conn.mergeSha.clear();
+    for (Node &entry : conn.nodes) {
+        if (entry.client != nullptr) {
+            loadMergeScript(conn, entry);
+        }
+    }
+}
+
+RedisDB::Connection &RedisDB::connect() {
+    std::lock_guard<std::mutex> lock(connectionsLock);
+    std::unique_ptr<Connection> &conn = connections[std::this_thread::get_id()];
+    if (!conn) {
+        auto created = std::make_unique<Connection>();
+        try {
+            Node &seed = node(*created, 0);
+            created->client = seed.client;
+            created->pipeline = seed.pipeline.get();
+        }
+        catch (...) {
+            connections.erase(std::this_thread::get_id());
+            throw;
+        }
+        created->cmdHash.set_client(created->client);
+        created->cmdKey.set_client(created->client);
+        conn = std::move(created);
+    }
+    cachedOwner = instanceId;
+    cachedConnection = conn.get();
+    return *conn;
+}
+
 void RedisDB::cleanup() {
-    redisConnection->clear();
-    if (redisConnection->quit() == false) {
-        LOG(WARNING) << redisConnection->result_error();
-        throw(std::runtime_error("Error in cleaning redisDB"));
+    std::unique_ptr<Connection> conn;
+    {
+        std::lock_guard<std::mutex> lock(connectionsLock);
+        auto found = connections.find(std::this_thread::get_id());
+        if (found == connections.end()) {
+            return;
+        }
+        conn = std::move(found->second);
+        connections.erase(found);
+    }
+    if (cachedOwner == instanceId) {
+        cachedOwner = 0;
+        cachedConnection = nullptr;
+    }
+    if (index) {
+        // Pipelined ZADDs and ZREMs share round trips with their HMSETs and DELs,
+        // so only the ones sent on their own have a time of their own.
+        LOG(INFO) << "# Redis index updates:\t" << conn->indexCommands << '\t'
+                  << conn->indexSeconds * 1000 << " ms waited" << std::endl;
+    }
+    if (clusterEnabled) {
+        LOG(INFO) << "# Redis cluster redirects:\t" << conn->redirects << std::endl;
+    }
+    std::lock_guard<std::mutex> lock(nodesLock);
+    for (std::size_t id = 0; id < conn->nodes.size(); ++id) {
+        if (conn->nodes[id].client != nullptr) {
+            nodePools[id]->put(conn->nodes[id].client, true);
+        }
     }
 }
 
 RedisDB::~RedisDB() {
-    delete redisClient;
-    delete redisClientCluster;
-}
-
-Status RedisDB::read(const std::string &table, const std::string &key, 
-                        const std::vector<std::string>& fields, std::vector<stringPair> &result) {
-    
-    if (fields.empty()) {
-        std::map<acl::string, acl::string> resultTemp;
-        cmdHash->hgetall(key.c_str(), resultTemp);
-        std::map<acl::string, acl::string>::iterator it;
-        for(it = resultTemp.begin(); it != resultTemp.end(); ++it){
-            std::string temp_first = static_cast<std::string>(it->first);
-            std::string temp_second = static_cast<std::string>(it->second);
-
-            stringPair stringPairTemp = std::make_pair(temp_first, temp_second);
-            result.push_back(stringPairTemp);
-        }
-    } 
-    else {
-        std::vector<acl::string> resultTemp;
-        std::vector<acl::string> fieldsTemp;
-
-        for(auto it = fields.begin(); it != fields.end(); ++it) {
-            acl::string tmpStr(*it->data());
-            fieldsTemp.push_back(tmpStr);
-        }
-        bool isSuccessed = cmdHash->hmget(key.c_str(), fieldsTemp, &resultTemp);
-        if(!isSuccessed){
-            return Status::OK;
-        }
-    }
-    return result.empty() ? Status::ERROR : Status::OK;  
-}
-
-Status RedisDB::scan(const std::string &table, const std::string &startkey, int recordcount, 
-                        std::vector<std::string> &fields, std::vector<std::vector<stringPair>> &result) {
-    // To-DO
-    // Set<String> keys = cmdHash->result_status(INDEX_KEY, hash(startkey),
-    // Double.POSITIVE_INFINITY, 0, recordcount);
-
-    // HashMap<String, ByteIterator> values;
-    // for (String key : keys) {
-    // values = new HashMap<String, ByteIterator>();
-    // read(table, key, fields, values);
-    // result.add(values);
-    // }
-return Status::FORBIDDEN;
-}
-
-Status RedisDB::update(const std::string &table, const std::string &key, 
-                        std::vector<stringPair> values) {
-    std::vector<stringPair>::iterator it;
-    std::vector<acl::string> namesTmp;
-    std::vector<acl::string> valuesTmp;
-    for(it = values.begin(); it != values.end(); ++it){
-        namesTmp.push_back(it->first.c_str());
-        valuesTmp.push_back(it->second.c_str());
-    }
-    if (cmdHash->hmset(key.c_str(), namesTmp, valuesTmp)) {
+    // Connections of threads that did not clean up go back before the pools close them all.
+    for (auto &conn : connections) {
+        for (std::size_t id = 0; id < conn.second->nodes.size(); ++id) {
+            if (conn.second->nodes[id].client != nullptr) {
+                nodePools[id]->put(conn.second->nodes[id].client, true);
+            }
+        }
+    }
+    connections.clear();
+    for (acl::redis_client_pool *pool : nodePools) {
+        delete pool;
+    }
+}
+
+Status RedisDB::read(const std::string &table, std::string_view key, 
+                        FieldList fields, ReadResult &result) {
+    Connection &conn = connection();
+    // One command on the pipeline: the reply is decoded into result as it
+    // is read, with the same code as pipelined reads.
+    DBOperation operation;
+    operation.table = &table;
+    operation.key = key;
+    operation.fields = fields;
+    operation.result = &result;
+    execute(conn, &operation, 1);
+    return operation.status;
+}
+
+Status RedisDB::scan(const std::string &table, std::string_view startkey, int recordcount, 
+                        FieldList fields, ScanResult &result) {
+    if (!index) {
+        return Status::FORBIDDEN;
+    }
+    Connection &conn = connection();
+    char score[24];
+    char count[24];
+    conn.pipeline->command(8);
+    conn.pipeline->argument("ZRANGEBYSCORE");
+    conn.pipeline->argument(RecordKey(table, INDEX_KEY, conn.keyName));
+    conn.pipeline->argument(hash(startkey, score));
+    conn.pipeline->argument("+inf");
+    conn.pipeline->argument("LIMIT");
+    conn.pipeline->argument("0");
+    conn.pipeline->argument(std::string_view(count, std::to_chars(count, count + sizeof(count), recordcount).ptr - count));
+    RespReply reply;
+    if (!conn.pipeline->send() || !conn.pipeline->read(reply)) {
+        LOG(WARNING) << "Redis pipeline connection failed, reconnecting";
+        conn.pipeline->reset();
+        return Status::SERVICE_UNAVAILABLE;
+    }
+    if (reply.type != '*') {
+        if (!conn.pipeline->skip(reply)) {
+            conn.pipeline->reset();
+            return Status::SERVICE_UNAVAILABLE;
+        }
+        return Status::ERROR;
+    }
+    // The keys are copied out of the reply, whose views the next read overwrites.
+    // The index holds them without the table, as the workload names them.
+    const std::size_t keys = static_cast<std::size_t>(reply.integer);
+    conn.scanKeys.resize(std::max(conn.scanKeys.size(), keys));
+    for (std::size_t i = 0; i < keys; ++i) {
+        RespReply element;
+        if (!conn.pipeline->element(element)) {
+            conn.pipeline->reset();
+            return Status::SERVICE_UNAVAILABLE;
+        }
+        conn.scanKeys[i].assign(element.text.data(), element.text.size());
+    }
+
+    const std::size_t first = result.size();
+    result.resize(first + keys);
+    conn.scanReads.resize(keys);
+    for (std::size_t i = 0; i < keys; ++i) {
+        DBOperation &read = conn.scanReads[i];
+        read.type = DBOperation::READ;
+        read.table = &table;
+        read.key = conn.scanKeys[i];
+        read.fields = fields;
+        read.result = &result[first + i];
+    }
+    execute(conn, conn.scanReads.data(), keys);
+
+    // A key deleted after the ZRANGEBYSCORE reads as empty and is left out.
+    std::size_t kept = first;
+    for (std::size_t i = 0; i < keys; ++i) {
+        if (conn.scanReads[i].status == Status::SERVICE_UNAVAILABLE) {
+            result.resize(first);
+            return Status::SERVICE_UNAVAILABLE;
+        }
+        if (conn.scanReads[i].status == Status::OK) {
+            if (kept != first + i) {
+                std::swap(result[kept], result[first + i]);
+            }
+            ++kept;
+        }
+    }
+    result.resize(kept);
+    return Status::OK;
+}
+
+Status RedisDB::update(const std::string &table, std::string_view key, 
+                        RecordView values) {
+    Connection &conn = connection();
+    if (clusterEnabled || layout != Layout::HASH) {
+        return executeOne(conn, DBOperation::UPDATE, table, key, values);
+    }
+    if (hmset(conn, table, key, values)) {
         return Status::OK;
     }
     return Status::ERROR;
 }
 
-Status RedisDB::insert(const std::string &table, const std::string &key, 
-                        std::vector<stringPair> &values) {
-    std::vector<stringPair>::iterator it;
-    std::vector<acl::string> namesTmp;
-    std::vector<acl::string> valuesTmp;
-    for(it = values.begin(); it != values.end(); ++it){
-        namesTmp.push_back(it->first.c_str());
-        valuesTmp.push_back(it->second.c_str());
+Status RedisDB::insert(const std::string &table, std::string_view key, 
+                        RecordView values) {
+    Connection &conn = connection();
+    if (clusterEnabled || layout != Layout::HASH) {
+        return executeOne(conn, DBOperation::INSERT, table, key, values);
+    }
+    if (!hmset(conn, table, key, values)) {
+        return Status::ERROR;
+    }
+    if (index) {
+        queueIndexAdd(conn, table, key);
+        return sendIndexCommand(conn);
+    }
+    return Status::OK;
+}
+
+bool RedisDB::hmset(Connection &conn, const std::string &table, std::string_view key, RecordView values) {
+    // acl sends binary-safe pointer/length arguments, so the views go to the
+    // socket without being copied into acl::string first.
+    const std::size_t count = values.size();
+    conn.argNames.resize(count);
+    conn.argNameLengths.resize(count);
+    conn.argValues.resize(count);
+    conn.argValueLengths.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        conn.argNames[i] = values[i].field.data();
+        conn.argNameLengths[i] = values[i].field.size();
+        conn.argValues[i] = values[i].value.data();
+        conn.argValueLengths[i] = values[i].value.size();
+    }
+    return conn.cmdHash.hmset(RecordKey(table, key, conn.keyName).c_str(), conn.argNames.data(), conn.argNameLengths.data(),
+                              conn.argValues.data(), conn.argValueLengths.data(), count);
+}
+
+Status RedisDB::Delete(const std::string &table, std::string_view key) {
+    Connection &conn = connection();
+    if (clusterEnabled) {
+        return executeOne(conn, DBOperation::DELETE, table, key, RecordView());
+    }
+    // A record is one key in every layout, so deleting it deletes the key.
+    RecordKey(table, key, conn.keyName);
+    Status status = conn.cmdKey.del_one(conn.keyName.data(), conn.keyName.size()) > 0 ? Status::OK : Status::ERROR;
+    if (index) {
+        queueIndexRemove(conn, table, key);
+        Status indexStatus = sendIndexCommand(conn);
+        if (status == Status::OK || indexStatus == Status::SERVICE_UNAVAILABLE) {
+            status = indexStatus;
+        }
+    }
+    return status;
+}
+
+void RedisDB::queueIndexAdd(Connection &conn, const std::string &table, std::string_view key) {
+    char score[24];
+    conn.pipeline->command(4);
+    conn.pipeline->argument("ZADD");
+    conn.pipeline->argument(RecordKey(table, INDEX_KEY, conn.keyName));
+    conn.pipeline->argument(hash(key, score));
+    conn.pipeline->argument(key);
+    ++conn.indexCommands;
+}
+
+void RedisDB::queueIndexRemove(Connection &conn, const std::string &table, std::string_view key) {
+    conn.pipeline->command(3);
+    conn.pipeline->argument("ZREM");
+    conn.pipeline->argument(RecordKey(table, INDEX_KEY, conn.keyName));
+    conn.pipeline->argument(key);
+    ++conn.indexCommands;
+}
+
+Status RedisDB::sendIndexCommand(Connection &conn) {
+    conn.indexTimer.Start();
+    if (!conn.pipeline->send()) {
+        conn.pipeline->reset();
+        return Status::SERVICE_UNAVAILABLE;
+    }
+    Status status = readIndexReply(conn);
+    conn.indexSeconds += conn.indexTimer.End();
+    if (status == Status::SERVICE_UNAVAILABLE) {
+        LOG(WARNING) << "Redis pipeline connection failed, reconnecting";
+        conn.pipeline->reset();
+    }
+    return status;
+}
+
+Status RedisDB::readIndexReply(Connection &conn) {
+    RespReply reply;
+    if (!conn.pipeline->read(reply) || !conn.pipeline->skip(reply)) {
+        return Status::SERVICE_UNAVAILABLE;
     }
-    if (cmdHash->hmset(key.c_str(), namesTmp, valuesTmp)) {
-        std::vector<std::pair<const char*, double>> tmpVector;
-        tmpVector.push_back(std::make_pair(INDEX_KEY.c_str(), hash(key)));
+    return reply.isError() ? Status::ERROR : Status::OK;
+}
+
+Status RedisDB::batchInsert(const std::string &table, const std::vector<KeyedRecord> &records) {
+    if (depth == 1) {
+        return DB::batchInsert(table, records);
+    }
+    Connection &conn = connection();
+    if (clusterEnabled) {
+        return clusterWrite(conn, table, records, DBOperation::INSERT);
+    }
+    return pipelinedWrite(conn, table, records, DBOperation::INSERT);
+}
+
+Status RedisDB::batchUpdate(const std::string &table, const std::vector<KeyedRecord> &records) {
+    if (depth == 1) {
+        return DB::batchUpdate(table, records);
+    }
+    Connection &conn = connection();
+    if (clusterEnabled) {
+        return clusterWrite(conn, table, records, DBOperation::UPDATE);
+    }
+    return pipelinedWrite(conn, table, records, DBOperation::UPDATE);
+}
+
+void RedisDB::executeBatch(std::vector<DBOperation> &operations) {
+    if (depth == 1) {
+        DB::executeBatch(operations);
+        return;
+    }
+    Connection &conn = connection();
+    std::size_t first = 0; // first operation not sent yet
+    for (std::size_t i = 0; i < operations.size(); ++i) {
+        DBOperation &operation = operations[i];
+        if (operation.type == DBOperation::SCAN) {
+            execute(conn, operations.data() + first, i - first);
+            operation.status = scan(*operation.table, operation.key, operation.recordCount,
+                                    operation.fields, *operation.scanResult);
+            first = i + 1;
+            continue;
+        }
+        if (i + 1 - first == depth) {
+            execute(conn, operations.data() + first, depth);
+            first = i + 1;
+        }
+    }
+    execute(conn, operations.data() + first, operations.size() - first);
+}
+
+void RedisDB::execute(Connection &conn, DBOperation *operations, std::size_t count) {
+    if (conn.scriptMissing) {
+        reloadMergeScript(conn);
+    }
+    if (clusterEnabled) {
+        clusterExecute(conn, operations, count);
+        return;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        queue(conn, *conn.pipeline, operations[i]);
+    }
+    sendQueued(conn, operations, count);
+}
+
+Status RedisDB::executeOne(Connection &conn, DBOperation::Type type, const std::string &table,
+                           std::string_view key, RecordView values) {
+    DBOperation operation;
+    operation.type = type;
+    operation.table = &table;
+    operation.key = key;
+    operation.values = values;
+    execute(conn, &operation, 1);
+    return operation.status;
+}
+
+void RedisDB::queue(Connection &conn, RespPipeline &pipeline, const DBOperation &operation) {
+    const std::string &table = *operation.table;
+    switch (operation.type) {
+        case DBOperation::READ:
+            if (layout != Layout::HASH) {
+                // The whole record comes back; readReply() picks the fields.
+                pipeline.command(2);
+                pipeline.argument("GET");
+                pipeline.argument(RecordKey(table, operation.key, conn.keyName));
+            } else if (operation.fields.empty()) {
+                pipeline.command(2);
+                pipeline.argument("HGETALL");
+                pipeline.argument(RecordKey(table, operation.key, conn.keyName));
+            } else {
+                pipeline.command(2 + operation.fields.size());
+                pipeline.argument("HMGET");
+                pipeline.argument(RecordKey(table, operation.key, conn.keyName));
+                for (const std::string &field : operation.fields) {
+                    pipeline.argument(field);
+                }
+            }
+            break;
+        case DBOperation::UPDATE:
+            queueWrite(conn, pipeline, operation.type, table, operation.key, operation.values);
+            break;
+        case DBOperation::INSERT:
+            queueWrite(conn, pipeline, operation.type, table, operation.key, operation.values);
+            if (index) {
+                queueIndexAdd(conn, table, operation.key);
+            }
+            break;
+        case DBOperation::DELETE:
+            pipeline.command(2);
+            pipeline.argument("DEL");
+            pipeline.argument(RecordKey(table, operation.key, conn.keyName));
+            if (index) {
+                queueIndexRemove(conn, table, operation.key);
+            }
+            break;
+        case DBOperation::SCAN:
+            break;
+    }
+}
+
+void RedisDB::queueWrite(Connection &conn, RespPipeline &pipeline, DBOperation::Type type,
+                         const std::string &table, std::string_view key, RecordView values) {
+    RecordKey(table, key, conn.keyName);
+    if (layout == Layout::HASH) {
+        queueHmset(pipeline, conn.keyName, values);
+        return;
+    }
+    if (layout == Layout::PACKED) {
+        PackedRecord::Encode(values, conn.encoded);
+    } else {
+        JsonRecord::Encode(values, conn.encoded);
+    }
+    if (type == DBOperation::INSERT) {
+        // An insert writes every field, so the record is replaced.
+        pipeline.command(3);
+        pipeline.argument("SET");
+        pipeline.argument(conn.keyName);
+        pipeline.argument(conn.encoded);
+        return;
+    }
+    // An update may write only some fields; the script merges them into the
+    // stored record on the server, in the same single command. Without a
+    // loaded script the script itself goes along.
+    pipeline.command(5);
+    if (conn.mergeSha.empty()) {
+        pipeline.argument("EVAL");
+        pipeline.argument(mergeScript());
+    } else {
+        pipeline.argument("EVALSHA");
+        pipeline.argument(conn.mergeSha);
+    }
+    pipeline.argument("1");
+    pipeline.argument(conn.keyName);
+    pipeline.argument(conn.encoded);
+}
+
+void RedisDB::queueHmset(RespPipeline &pipeline, std::string_view key, RecordView values) {
+    pipeline.command(2 + 2 * values.size());
+    pipeline.argument("HMSET");
+    pipeline.argument(key);
+    for (const FieldValue &value : values) {
+        pipeline.argument(value.field);
+        pipeline.argument(value.value);
+    }
+}
+
+void RedisDB::sendQueued(Connection &conn, DBOperation *operations, std::size_t count) {
+    if (count == 0) {
+        return;
+    }
+    // Every operation gets the status of its own reply. Once the connection
+    // fails the rest cannot be matched to replies and are unavailable.
+    bool connected = conn.pipeline->send();
+    for (std::size_t i = 0; i < count; ++i) {
+        DBOperation &operation = operations[i];
+        operation.status = (connected ? readReply(conn, *conn.pipeline, operation) : Status::SERVICE_UNAVAILABLE);
+        connected = !(operation.status == Status::SERVICE_UNAVAILABLE);
+        if (connected && index &&
+            (operation.type == DBOperation::INSERT || operation.type == DBOperation::DELETE)) {
+            Status indexStatus = readIndexReply(conn);
+            if (operation.status == Status::OK || indexStatus == Status::SERVICE_UNAVAILABLE) {
+                operation.status = indexStatus;
+            }
+            connected = !(indexStatus == Status::SERVICE_UNAVAILABLE);
+        }
+    }
+    if (!connected) {
+        LOG(WARNING) << "Redis pipeline connection failed, reconnecting";
+        conn.pipeline->reset();
+    }
+}
+
+Status RedisDB::readReply(Connection &conn, RespPipeline &pipeline, DBOperation &operation,
+                          Redirect *redirect) {
+    RespReply reply;
+    if (!pipeline.read(reply)) {
+        return Status::SERVICE_UNAVAILABLE;
+    }
+    if (operation.type == DBOperation::READ && layout != Layout::HASH && reply.type == '$') {
+        // GET: the record is decoded from the input buffer into the result.
+        ReadResult &result = *operation.result;
+        const std::size_t first = result.size();
+        if (reply.isNil()) {
+            return Status::ERROR;
+        }
+        bool decoded = (layout == Layout::PACKED ?
+                        PackedRecord::Decode(reply.text, operation.fields, result) :
+                        JsonRecord::Decode(reply.text, operation.fields, result));
+        if (!decoded) {
+            result.resize(first);
+            return Status::ERROR;
+        }
+        return result.size() == first ? Status::ERROR : Status::OK;
+    }
+    if (operation.type != DBOperation::READ || reply.type != '*') {
+        if (!pipeline.skip(reply)) {
+            return Status::SERVICE_UNAVAILABLE;
+        }
+        if (reply.isError() && redirect != nullptr) {
+            ParseRedirect(reply.text, *redirect);
+        }
+        if (reply.isError() && reply.text.compare(0, 8, "NOSCRIPT") == 0) {
+            // The server lost the script, e.g. to SCRIPT FLUSH or a restart.
+            LOG(WARNING) << "Redis merge script missing, loading it again";
+            conn.scriptMissing = true;
+        }
+        if (reply.isError() || operation.type == DBOperation::READ) {
+            return Status::ERROR;
+        }
+        if (operation.type == DBOperation::DELETE) {
+            return reply.integer > 0 ? Status::OK : Status::ERROR;
+        }
         return Status::OK;
     }
-    return Status::ERROR;
+    // HGETALL replies with name/value pairs, HMGET with the values of the
+    // fields asked for, nil for missing ones. Names and values are decoded
+    // straight into the strings of the result, without an acl::string or map.
+    ReadResult &result = *operation.result;
+    const bool allFields = operation.fields.empty();
+    if (allFields && reply.integer % 2 != 0) {
+        return Status::SERVICE_UNAVAILABLE;
+    }
+    bool nil = false;
+    for (int64_t i = 0; i < reply.integer; ++i) {
+        if (allFields) {
+            result.emplace_back();
+            if (!pipeline.bulk(result.back().first, nil) ||
+                !pipeline.bulk(result.back().second, nil)) {
+                return Status::SERVICE_UNAVAILABLE;
+            }
+            ++i;
+        } else if (static_cast<std::size_t>(i) < operation.fields.size()) {
+            result.emplace_back().first.assign(operation.fields[i]);
+            if (!pipeline.bulk(result.back().second, nil)) {
+                return Status::SERVICE_UNAVAILABLE;
+            }
+            if (nil) {
+                result.pop_back();
+            }
+        } else {
+            RespReply extra;
+            if (!pipeline.element(extra) || !pipeline.skip(extra)) {
+                return Status::SERVICE_UNAVAILABLE;
+            }
+        }
+    }
+    return operation.result->empty() ? Status::ERROR : Status::OK;
+}
+
+Status RedisDB::pipelinedWrite(Connection &conn, const std::string &table,
+                               const std::vector<KeyedRecord> &records, DBOperation::Type type) {
+    Status status = Status::OK;
+    const bool indexed = (index && type == DBOperation::INSERT);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        queueWrite(conn, *conn.pipeline, type, table, records[i].key, records[i].values);
+        if (indexed) {
+            queueIndexAdd(conn, table, records[i].key);
+        }
+        if ((i + 1) % depth != 0 && i + 1 < records.size()) {
+            continue;
+        }
+        bool connected = conn.pipeline->send();
+        while (connected && conn.pipeline->queued() > 0) {
+            RespReply reply;
+            connected = conn.pipeline->read(reply) && conn.pipeline->skip(reply);
+            if (connected && reply.isError()) {
+                status = Status::ERROR;
+            }
+        }
+        if (!connected) {
+            LOG(WARNING) << "Redis pipeline connection failed, reconnecting";
+            conn.pipeline->reset();
+            status = Status::SERVICE_UNAVAILABLE;
+        }
+    }
+    return status;
 }
 
-Status RedisDB::Delete(const std::string &table, const std::string &key) {
-    return cmdHash->hdel_fields(key.c_str(), table.c_str()) == 0 ? Status::ERROR
-        : Status::OK;
+void RedisDB::clusterExecute(Connection &conn, DBOperation *operations, std::size_t count) {
+    if (count == 0) {
+        return;
+    }
+    if (conn.slots.empty() || conn.slotsStale) {
+        refreshSlots(conn);
+    }
+    conn.routes.resize(std::max(conn.routes.size(), count));
+    conn.pending.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        conn.routes[i].asking = false;
+        conn.pending.push_back(i);
+    }
+    for (int attempt = 0; !conn.pending.empty(); ++attempt) {
+        // Queue every operation on the node of its slot, or the one an ASK
+        // named, then write each node's commands before waiting for a reply.
+        for (std::size_t i : conn.pending) {
+            Route &route = conn.routes[i];
+            if (!route.asking) {
+                route.node = conn.slots[KeySlot(RecordKey(*operations[i].table, operations[i].key, conn.keyName))];
+            }
+            RespPipeline &pipeline = *node(conn, route.node).pipeline;
+            if (route.asking) {
+                pipeline.command(1);
+                pipeline.argument("ASKING");
+            }
+            queue(conn, pipeline, operations[i]);
+        }
+        for (Node &peer : conn.nodes) {
+            peer.connected = (!peer.pipeline || peer.pipeline->queued() == 0 || peer.pipeline->send());
+        }
+
+        // Each node replies in the order its commands were queued, which is
+        // the order of the operations.
+        conn.redirected.clear();
+        for (std::size_t i : conn.pending) {
+            Route &route = conn.routes[i];
+            Node &peer = conn.nodes[route.node];
+            DBOperation &operation = operations[i];
+            if (route.asking) {
+                RespReply asking;
+                peer.connected = peer.connected && peer.pipeline->read(asking) && peer.pipeline->skip(asking);
+                route.asking = false;
+            }
+            if (!peer.connected) {
+                operation.status = Status::SERVICE_UNAVAILABLE;
+                continue;
+            }
+            Redirect redirect;
+            operation.status = readReply(conn, *peer.pipeline, operation, &redirect);
+            if (operation.status == Status::SERVICE_UNAVAILABLE) {
+                peer.connected = false;
+                continue;
+            }
+            if (redirect.address.empty() || attempt == MAX_REDIRECTS) {
+                continue;
+            }
+            ++conn.redirects;
+            std::size_t target = nodeId(redirect.address);
+            if (redirect.ask) {
+                // The slot is moving; only this command goes to the new node.
+                route.node = target;
+                route.asking = true;
+            } else {
+                conn.slots[redirect.slot] = static_cast<uint16_t>(target);
+                conn.slotsStale = true;
+            }
+            conn.redirected.push_back(i);
+        }
+        for (Node &peer : conn.nodes) {
+            if (!peer.connected) {
+                LOG(WARNING) << "Redis pipeline connection failed, reconnecting";
+                peer.pipeline->reset();
+                peer.connected = true;
+            }
+        }
+        conn.pending.swap(conn.redirected);
+    }
+}
+
+Status RedisDB::clusterWrite(Connection &conn, const std::string &table,
+                             const std::vector<KeyedRecord> &records, DBOperation::Type type) {
+    Status status = Status::OK;
+    conn.batchWrites.resize(std::max(conn.batchWrites.size(), depth));
+    for (std::size_t first = 0; first < records.size(); first += depth) {
+        const std::size_t count = std::min(depth, records.size() - first);
+        for (std::size_t i = 0; i < count; ++i) {
+            DBOperation &write = conn.batchWrites[i];
+            write.type = type;
+            write.table = &table;
+            write.key = records[first + i].key;
+            write.values = records[first + i].values;
+        }
+        clusterExecute(conn, conn.batchWrites.data(), count);
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!(conn.batchWrites[i].status == Status::OK)) {
+                status = conn.batchWrites[i].status;
+            }
+        }
+    }
+    return status;
+}
+
+bool RedisDB::refreshSlots(Connection &conn) {
+    // Slots no range covers stay with the configured node, which redirects
+    // them; if CLUSTER SLOTS fails, all of them do.
+    conn.slots.assign(CLUSTER_SLOTS, 0);
+    conn.slotsStale = false;
+    RespPipeline &pipeline = *conn.pipeline;
+    pipeline.command(2);
+    pipeline.argument("CLUSTER");
+    pipeline.argument("SLOTS");
+    RespReply reply;
+    bool connected = pipeline.send() && pipeline.read(reply);
+    if (connected && reply.type != '*') {
+        connected = pipeline.skip(reply);
+        if (connected) {
+            LOG(WARNING) << "Redis CLUSTER SLOTS failed: " << reply.text;
+            return false;
+        }
+    }
+    for (int64_t i = 0; connected && i < reply.integer; ++i) {
+        connected = readSlotRange(conn);
+    }
+    if (!connected) {
+        LOG(WARNING) << "Redis CLUSTER SLOTS could not be read, reconnecting";
+        pipeline.reset();
+    }
+    return connected;
+}
+
+bool RedisDB::readSlotRange(Connection &conn) {
+    // [start, end, [host, port, id...], replicas...]
+    RespPipeline &pipeline = *conn.pipeline;
+    RespReply range, start, end, master, host, port;
+    if (!pipeline.element(range) || range.type != '*' || range.integer < 3 ||
+        !pipeline.element(start) || !pipeline.element(end) ||
+        !pipeline.element(master) || master.type != '*' || master.integer < 2 ||
+        !pipeline.element(host)) {
+        return false;
+    }
+    // An empty host is the host the reply came from.
+    std::string address(host.text.empty() ? std::string_view(seedHost) : host.text);
+    if (!pipeline.element(port)) {
+        return false;
+    }
+    for (int64_t i = 2; i < master.integer; ++i) {
+        RespReply field;
+        if (!pipeline.element(field) || !pipeline.skip(field)) {
+            return false;
+        }
+    }
+    for (int64_t i = 3; i < range.integer; ++i) {
+        RespReply replica;
+        if (!pipeline.element(replica) || !pipeline.skip(replica)) {
+            return false;
+        }
+    }
+    address += ':' + std::to_string(port.integer);
+    const uint16_t id = static_cast<uint16_t>(nodeId(address));
+    for (int64_t slot = std::max<int64_t>(start.integer, 0);
+         slot <= end.integer && slot < static_cast<int64_t>(CLUSTER_SLOTS); ++slot) {
+        conn.slots[slot] = id;
+    }
+    return true;
 }
 
 } // namespace redisdb
@@ -4,8 +4,16 @@
 #define _DBBENCHMARK_REDISDB_H_
 
 #include "Core/DB.h"
+#include "Core/Utility/Timer.h"
+#include "ClusterSlots.h"
+#include "RecordLayout.h"
+#include "RespPipeline.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <acl_cpp/lib_acl.hpp>
 
 namespace dbbenchmark {
@@ -13,8 +21,16 @@ namespace redisdb {
 
 /**
 *   \brief RedisDB client wrapper for acl Redis library.
-*   \details  Database accessing layer. Each thread in the client will be given its own instance of whatever DB 
-*     class is to be used in the test. This class should be constructed using a no-argument 
+*   \details  Database accessing layer. One instance is shared by all threads of the client: every
+*     node has a connection pool of max_conns connections, and each thread takes its own connection
+*     and command objects on its first command to the node and gives them back in cleanup().
+*     In cluster mode each thread keeps a map of the hash slots to their nodes, read with CLUSTER
+*     SLOTS and patched by MOVED replies; a batch is split by node, every node's commands go out
+*     in one write, and redirected commands are sent again to the node named in the reply.
+*     A record is stored at "<table>:<key>", so tables that use the same key names stay apart.
+*     Records are hashes by default; the packed and json layouts store each one as a single
+*     string read with GET, written whole with SET and merged into by a Lua script on update.
+*     This class should be constructed using a no-argument 
 *     constructor, so we can load it dynamically. Any argument-based initialization 
 *     should be done by init().
 *   \author Ozgun AY
@@ -30,46 +46,203 @@ const std::string PASSWORD_PROPERTY = SETTINGS_TAG + "password";
 const std::string CLUSTER_PROPERTY = SETTINGS_TAG + "cluster";
 const std::string CONN_TIMEOUT = SETTINGS_TAG + "conn_timeout";
 const std::string RW_TIMEOUT = SETTINGS_TAG + "rw_timeout";
+// Connections of the pool, per node in cluster mode; at least one per client thread.
 const std::string MAX_CONNS = SETTINGS_TAG + "max_conns";
-const std::string INDEX_KEY = SETTINGS_TAG + "_indices";
+// Commands sent per round trip; 1 waits for each reply before sending the next.
+const std::string PIPELINE_PROPERTY = SETTINGS_TAG + "pipeline";
+// Keep the sorted-set index scans range over, at the cost of a ZADD per insert and a ZREM per delete.
+const std::string INDEX_PROPERTY = SETTINGS_TAG + "index";
+// Sorted set of every key of a table, scored by the key's hash; stored as "<table>:_indices".
+const std::string INDEX_KEY = "_indices";
+// Record layout: hash, a field per column, or packed or json, the whole record in one string.
+const std::string LAYOUT_PROPERTY = SETTINGS_TAG + "layout";
+// Times a command follows MOVED or ASK before it fails.
+const int MAX_REDIRECTS = 5;
 
 class RedisDB : public DB {
 public:
     RedisDB() {
-        redisClient = nullptr;
-        redisClientCluster = nullptr;
+        clusterEnabled = false;
+        connTimeout = 0;
+        rwTimeout = 0;
+        maxConns = 0;
+        depth = 1;
+        index = false;
+        layout = Layout::HASH;
+        instanceId = ++instanceCount;
         m_localConf = &(utility::programconfigurations::LayeredConfiguration::Instance());
     };
 
     void init() override;
+    /** Give the calling thread's connection back to the pool. */
     void cleanup() override;
-    Status read(const std::string &table, const std::string &key, 
-                    const std::vector<std::string>& fields, std::vector<stringPair> &result) override;
-    Status scan(const std::string &table, const std::string &startkey, int recordcount, 
-                    std::vector<std::string> &fields, std::vector<std::vector<stringPair>> &result) override;
-    Status update(const std::string &table, const std::string &key, 
-                    std::vector<stringPair> values) override;
-    Status insert(const std::string &table, const std::string &key, 
-                    std::vector<stringPair> &values) override;
-    Status Delete(const std::string &table, const std::string &key) override;
+    Status read(const std::string &table, std::string_view key, 
+                    FieldList fields, ReadResult &result) override;
+    /** ZRANGEBYSCORE the keys of the index from startkey's hash on, then read them with one
+    * pipeline of reads. FORBIDDEN without the index.
+    */
+    Status scan(const std::string &table, std::string_view startkey, int recordcount, 
+                    FieldList fields, ScanResult &result) override;
+    Status update(const std::string &table, std::string_view key, 
+                    RecordView values) override;
+    Status insert(const std::string &table, std::string_view key, 
+                    RecordView values) override;
+    Status Delete(const std::string &table, std::string_view key) override;
+    /** With a pipeline, send the records pipeline() writes per round trip. */
+    Status batchInsert(const std::string &table, const std::vector<KeyedRecord> &records) override;
+    Status batchUpdate(const std::string &table, const std::vector<KeyedRecord> &records) override;
+    std::size_t pipelineDepth() const override { return depth; }
+    /** With a pipeline, send the operations pipelineDepth() per round trip and match the replies
+    * back in order. Scans are executed on their own, after the commands before them.
+    */
+    void executeBatch(std::vector<DBOperation> &operations) override;
 
     ~RedisDB();
 
 protected:
 
 private:
+    /*
+    * What one thread needs to run commands: its connection, the command objects
+    * bound to it and the buffers they reuse from one call to the next.
+    */
+    struct Node {
+        acl::redis_client *client = nullptr; /// Taken from the node's pool
+        std::unique_ptr<RespPipeline> pipeline; /// Raw commands on client
+        bool connected = true; /// Cleared when a batch finds the connection failed
+    };
+    /// The node an operation of a cluster batch goes to, and whether an ASK sent it there.
+    struct Route {
+        std::size_t node = 0;
+        bool asking = false;
+    };
+    struct Connection {
+        std::vector<Node> nodes; /// By node id; only node 0, the configured one, outside cluster mode
+        acl::redis_client *client = nullptr; /// nodes[0]'s
+        acl::redis_hash cmdHash; /// On client
+        acl::redis_key cmdKey;
+        /// nodes[0]'s: pipelines, the index and scans
+        RespPipeline *pipeline = nullptr;
+        std::vector<const char*> argNames;
+        std::vector<size_t> argNameLengths;
+        std::vector<const char*> argValues;
+        std::vector<size_t> argValueLengths;
+        uint64_t indexCommands = 0; /// ZADDs and ZREMs sent
+        double indexSeconds = 0; /// Time spent waiting on the ones sent on their own
+        utility::Timer<double> indexTimer;
+        std::vector<std::string> scanKeys;
+        std::vector<DBOperation> scanReads;
+        std::vector<uint16_t> slots; /// Cluster mode: node id of every hash slot
+        bool slotsStale = false; /// A MOVED changed slots since CLUSTER SLOTS filled them
+        uint64_t redirects = 0; /// MOVED and ASK replies
+        std::vector<Route> routes; /// Of the operations of a cluster batch
+        std::vector<std::size_t> pending; /// Operations of a cluster batch still to send
+        std::vector<std::size_t> redirected;
+        std::vector<DBOperation> batchWrites; /// The records of a cluster batch write
+        std::string keyName; /// The Redis key of the command being queued, "<table>:<key>"
+        std::string encoded; /// Packed or json layout: the record being queued
+        std::string mergeSha; /// Packed or json layout: SHA1 of the merge script, as SCRIPT LOAD returned it; empty sends it with EVAL
+        bool scriptMissing = false; /// An update got NOSCRIPT; the script is loaded again before the next batch
+    };
+
+    /// The calling thread's connection; the first call of a thread sets it up.
+    Connection &connection() {
+        if (cachedOwner != instanceId) {
+            return connect();
+        }
+        return *cachedConnection;
+    }
+    Connection &connect();
+    /// conn's client of the node, taken from the node's pool on first use.
+    Node &node(Connection &conn, std::size_t id);
+    /// Id of the node at address, "host:port", with a pool created for a new one.
+    std::size_t nodeId(const std::string &address);
+    /// SCRIPT LOAD the merge script of the layout on a node's new connection.
+    void loadMergeScript(Connection &conn, Node &entry);
+    /// SCRIPT LOAD it again on every node of conn, after one replied NOSCRIPT.
+    void reloadMergeScript(Connection &conn);
+    /// Lua source of the merge script of the layout.
+    const char *mergeScript() const {
+        return layout == Layout::PACKED ? PACKED_MERGE_SCRIPT : JSON_MERGE_SCRIPT;
+    }
+
     /*
     * Calculate a hash for a key to store it in an index. The actual return value
     * of this function is not interesting -- it primarily needs to be fast and
     * scattered along the whole space of doubles. In a real world scenario one
-    * would probably use the ASCII values of the keys.
+    * would probably use the ASCII values of the keys. It is written into digits
+    * as a decimal integer of 53 bits, which a score holds exactly, so ZADD and
+    * ZRANGEBYSCORE agree on it.
+    */
+    std::string_view hash(std::string_view key, char (&digits)[24]) {
+        uint64_t score = std::hash<std::string_view>{}(key) >> 11;
+        return std::string_view(digits, std::to_chars(digits, digits + sizeof(digits), score).ptr - digits);
+    };
+    /*
+    * HMSET the record. The argument arrays are members of the connection so
+    * their capacity is reused from one call to the next.
     */
-    double hash(const std::string &key) { return std::hash<std::string>{}(key); };
-    acl::redis_client *redisClient; // acl::redis library uses raw pointers so here we have to use raw pointer
-    acl::redis_client_cluster *redisClientCluster; // acl::redis library uses raw pointers so here we have to use raw pointer
-    std::unique_ptr<acl::redis_hash> cmdHash;
-    std::unique_ptr<acl::redis_connection> redisConnection;
-    //std::unique_ptr<acl::redis_zset> zSet;
+    bool hmset(Connection &conn, const std::string &table, std::string_view key, RecordView values);
+    /*
+    * Pipelined commands. execute() sends operations and takes their replies:
+    * queue() encodes the command of an operation, sendQueued() writes
+    * everything queued on conn.pipeline and takes the reply of each command in
+    * order, clusterExecute() does the same on the node of each key.
+    */
+    void execute(Connection &conn, DBOperation *operations, std::size_t count);
+    /// execute() a single write or delete.
+    Status executeOne(Connection &conn, DBOperation::Type type, const std::string &table,
+                      std::string_view key, RecordView values);
+    void queue(Connection &conn, RespPipeline &pipeline, const DBOperation &operation);
+    /// The command writing a record in the layout: HMSET, or SET for an insert and the merge script for an update.
+    void queueWrite(Connection &conn, RespPipeline &pipeline, DBOperation::Type type,
+                    const std::string &table, std::string_view key, RecordView values);
+    void queueHmset(RespPipeline &pipeline, std::string_view key, RecordView values);
+    /// ZADD or ZREM key in the index of table.
+    void queueIndexAdd(Connection &conn, const std::string &table, std::string_view key);
+    void queueIndexRemove(Connection &conn, const std::string &table, std::string_view key);
+    /// A MOVED or ASK error is parsed into redirect, if given.
+    /// A NOSCRIPT error sets conn.scriptMissing.
+    Status readReply(Connection &conn, RespPipeline &pipeline, DBOperation &operation,
+                     Redirect *redirect = nullptr);
+    /// Reply of a ZADD or ZREM; only an error reply fails.
+    Status readIndexReply(Connection &conn);
+    /// Send the index command just queued on its own and wait for its reply.
+    Status sendIndexCommand(Connection &conn);
+    void sendQueued(Connection &conn, DBOperation *operations, std::size_t count);
+    /// Write records as operations of type, depth per round trip, inserts with their ZADDs if indexed.
+    Status pipelinedWrite(Connection &conn, const std::string &table,
+                          const std::vector<KeyedRecord> &records, DBOperation::Type type);
+    void clusterExecute(Connection &conn, DBOperation *operations, std::size_t count);
+    /// Write records as operations of type, depth per clusterExecute().
+    Status clusterWrite(Connection &conn, const std::string &table,
+                        const std::vector<KeyedRecord> &records, DBOperation::Type type);
+    /// Fill conn.slots from CLUSTER SLOTS of the configured node.
+    bool refreshSlots(Connection &conn);
+    /// Read one slot range of the CLUSTER SLOTS reply into conn.slots.
+    bool readSlotRange(Connection &conn);
+
+    bool clusterEnabled;
+    std::string seedHost; /// Host of node 0, for nodes CLUSTER SLOTS lists without one
+    int connTimeout;
+    int rwTimeout;
+    std::string password;
+    int maxConns;
+    std::size_t depth; /// Pipeline depth, 1 without a pipeline
+    bool index; /// Maintain the index of INDEX_KEY
+    Layout layout; /// How records are stored
+    std::mutex connectionsLock;
+    std::unordered_map<std::thread::id, std::unique_ptr<Connection>> connections;
+    std::mutex nodesLock;
+    std::vector<std::string> nodeAddresses; /// By node id
+    std::vector<acl::redis_client_pool*> nodePools; // acl::redis library uses raw pointers so here we have to use raw pointer
+
+    /// Distinguishes instances in the per-thread cache, which outlives them.
+    uint64_t instanceId;
+    static std::atomic<uint64_t> instanceCount;
+    /// The connection connection() returned last on this thread, and its instance.
+    static thread_local uint64_t cachedOwner;
+    static thread_local Connection *cachedConnection;
 };
 
 } // namespace redisdb
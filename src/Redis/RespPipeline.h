@@ -0,0 +1,269 @@
+// RespPipeline.h
+
+#ifndef _DBBENCHMARK_RESPPIPELINE_H_
+#define _DBBENCHMARK_RESPPIPELINE_H_
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include <acl_cpp/lib_acl.hpp>
+
+namespace dbbenchmark {
+namespace redisdb {
+
+///
+/// One RESP reply, or the header of an array reply. text is a view into the
+/// pipeline's input buffer, valid until the next reply is read.
+///
+struct RespReply {
+    char type = 0;        /// '+' status, '-' error, ':' integer, '$' bulk string, '*' array
+    int64_t integer = 0;  /// Value of an integer, length of a bulk string, size of an array; -1 for nil
+    std::string_view text;  /// Status or error line, or the bulk string
+
+    bool isError() const { return type == '-'; }
+    bool isNil() const { return (type == '$' || type == '*') && integer < 0; }
+};
+
+/**
+*   \brief Raw RESP writer and reader on the socket of an acl redis_client.
+*   \details Commands are encoded into one output buffer and written with a single call by send(),
+*       then their replies are read back in order, so a whole pipeline costs one round trip instead
+*       of one per command. Arguments are binary-safe views, copied only into the output buffer;
+*       bulk() decodes a reply string straight into the caller's string.
+*       The acl client keeps the connection, and its own commands can be used in between as long
+*       as no reply of the pipeline is still unread. RedisClient is acl::redis_client, see
+*       RespPipeline; anything with its get_stream() and close() will do, e.g. canned input in tests.
+*   \author Ozgun AY
+*   \version 1.0
+*   \date 21/11/2018
+*   \bug None so far
+*/
+template <typename RedisClient>
+class BasicRespPipeline {
+public:
+    explicit BasicRespPipeline(RedisClient *client) : client(client), queuedCount(0), inPos(0) { }
+
+    /** Start a command of argc arguments, the command name included. */
+    void command(std::size_t argc) {
+        header('*', argc);
+        ++this->queuedCount;
+    }
+    /** Append the next argument of the current command. */
+    void argument(std::string_view value) {
+        header('$', value.size());
+        this->out.append(value.data(), value.size());
+        this->out.append("\r\n", 2);
+    }
+
+    /** Number of commands whose replies have not been read yet. */
+    std::size_t queued() const { return this->queuedCount; }
+
+    /** Write every command queued so far.
+    * @return false if the connection failed; reset() must be called then.
+    */
+    bool send();
+    /** Read the reply of the next queued command. For an array this is the header; read its
+    * reply.integer elements with element().
+    * @return false if the connection failed or the reply is malformed.
+    */
+    bool read(RespReply &reply) {
+        --this->queuedCount;
+        return parse(reply);
+    }
+    /** Read the next element of an array reply. */
+    bool element(RespReply &reply) { return parse(reply); }
+    /** Read the next element of an array reply, a bulk string, into out. Its bytes are copied once:
+    * from the input buffer if they were read already, straight from the socket otherwise.
+    * @param nil Set if the element is nil; out is empty then.
+    */
+    bool bulk(std::string &out, bool &nil);
+    /** Read and drop the elements of a reply whose header was just read, e.g. an unexpected array. */
+    bool skip(const RespReply &reply);
+
+    /** Forget everything queued or unread and close the connection; acl reconnects on its next
+    * command.
+    */
+    void reset();
+
+private:
+    void header(char type, std::size_t value) {
+        char digits[24];
+        digits[0] = type;
+        char *end = std::to_chars(digits + 1, digits + sizeof(digits) - 2, value).ptr;
+        *end++ = '\r';
+        *end++ = '\n';
+        this->out.append(digits, end - digits);
+    }
+    /// Read more input, keeping the unread part at the front of the buffer.
+    bool fill();
+    /// Next CRLF terminated line, without the CRLF.
+    bool line(std::string_view &text);
+    bool parse(RespReply &reply);
+
+    RedisClient *client;
+    std::string out;        /// Encoded commands not sent yet
+    std::size_t queuedCount;
+    std::string in;         /// Input read so far, consumed from inPos
+    std::size_t inPos;
+};
+
+template <typename RedisClient>
+inline bool BasicRespPipeline<RedisClient>::send() {
+    auto *stream = this->client->get_stream();
+    if (stream == nullptr) {
+        return false;
+    }
+    bool sent = this->out.empty() || stream->write(this->out.data(), this->out.size()) != -1;
+    this->out.clear();
+    return sent;
+}
+
+template <typename RedisClient>
+inline bool BasicRespPipeline<RedisClient>::fill() {
+    auto *stream = this->client->get_stream();
+    if (stream == nullptr) {
+        return false;
+    }
+    if (this->inPos > 0) {
+        this->in.erase(0, this->inPos);
+        this->inPos = 0;
+    }
+    const std::size_t kChunk = 16384;
+    std::size_t used = this->in.size();
+    this->in.resize(used + kChunk);
+    int count = stream->read(&this->in[used], kChunk, false);
+    this->in.resize(used + (count > 0 ? count : 0));
+    return count > 0;
+}
+
+template <typename RedisClient>
+inline bool BasicRespPipeline<RedisClient>::line(std::string_view &text) {
+    std::size_t scanned = this->inPos;
+    for (;;) {
+        std::size_t end = this->in.find("\r\n", scanned);
+        if (end != std::string::npos) {
+            text = std::string_view(this->in.data() + this->inPos, end - this->inPos);
+            this->inPos = end + 2;
+            return true;
+        }
+        // fill() moves the unread input to the front; keep scanning from where we stopped.
+        std::size_t unread = this->in.size() - this->inPos;
+        scanned = (unread > 0 ? unread - 1 : 0);
+        if (!fill()) {
+            return false;
+        }
+    }
+}
+
+template <typename RedisClient>
+inline bool BasicRespPipeline<RedisClient>::parse(RespReply &reply) {
+    std::string_view text;
+    if (!line(text) || text.empty()) {
+        return false;
+    }
+    reply.type = text[0];
+    reply.integer = 0;
+    reply.text = text.substr(1);
+    switch (reply.type) {
+        case '+':
+        case '-':
+            break;
+        case ':':
+        case '*':
+        case '$': {
+            const char *end = text.data() + text.size();
+            if (std::from_chars(text.data() + 1, end, reply.integer).ptr != end) {
+                return false;
+            }
+            reply.text = std::string_view();
+            if (reply.type == '$' && reply.integer >= 0) {
+                const std::size_t length = static_cast<std::size_t>(reply.integer);
+                while (this->in.size() - this->inPos < length + 2) {
+                    if (!fill()) {
+                        return false;
+                    }
+                }
+                reply.text = std::string_view(this->in.data() + this->inPos, length);
+                this->inPos += length + 2;
+            }
+            break;
+        }
+        default:
+            return false;
+    }
+    return true;
+}
+
+template <typename RedisClient>
+inline bool BasicRespPipeline<RedisClient>::bulk(std::string &out, bool &nil) {
+    std::string_view text;
+    if (!line(text) || text.size() < 2 || text[0] != '$') {
+        return false;
+    }
+    int64_t length = 0;
+    const char *end = text.data() + text.size();
+    if (std::from_chars(text.data() + 1, end, length).ptr != end) {
+        return false;
+    }
+    nil = (length < 0);
+    const std::size_t size = (nil ? 0 : static_cast<std::size_t>(length));
+    out.resize(size);
+    std::size_t copied = std::min(size, this->in.size() - this->inPos);
+    std::memcpy(&out[0], this->in.data() + this->inPos, copied);
+    this->inPos += copied;
+    // The input buffer is empty now; the rest of a long value skips it.
+    while (copied < size) {
+        auto *stream = this->client->get_stream();
+        int count = (stream == nullptr ? -1 : stream->read(&out[copied], size - copied, false));
+        if (count <= 0) {
+            return false;
+        }
+        copied += count;
+    }
+    if (nil) {
+        return true;
+    }
+    while (this->in.size() - this->inPos < 2) {
+        if (!fill()) {
+            return false;
+        }
+    }
+    this->inPos += 2;
+    return true;
+}
+
+template <typename RedisClient>
+inline bool BasicRespPipeline<RedisClient>::skip(const RespReply &reply) {
+    if (reply.type != '*') {
+        return true;
+    }
+    for (int64_t i = 0; i < reply.integer; ++i) {
+        RespReply element;
+        if (!parse(element) || !skip(element)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename RedisClient>
+inline void BasicRespPipeline<RedisClient>::reset() {
+    this->out.clear();
+    this->in.clear();
+    this->inPos = 0;
+    this->queuedCount = 0;
+    this->client->close();
+}
+
+/// The pipeline RedisDB runs on the connections of its acl pools.
+typedef BasicRespPipeline<acl::redis_client> RespPipeline;
+
+} // namespace redisdb
+} // namespace dbbenchmark
+
+#endif // _DBBENCHMARK_RESPPIPELINE_H_
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <iostream>
@@ -12,8 +13,10 @@
 #include "Core/Utility/LoggerSink.hpp"
 #include "Core/Utility/Utils.h"
 #include "Core/Utility/Timer.h"
-#include "Core/Client.h"
+#include "Core/Utility/AllocationCounter.h"
+#include "Core/BasicClient.h"
 #include "Core/Workloads/CoreWorkload.h"
+#include "Core/Workloads/OperationStream.h"
 #include "Core/DBFactory.h"
 
 using namespace std;
@@ -22,21 +25,48 @@ using namespace dbbenchmark::utility::programconfigurations;
 
 static const std::string IDR_CONF_PATH = "GeneralSettings.configurationpath";
 static const std::string IDR_CONF_DEFAULT_FILENAME = "dbsettings.xml";
+// "run" generates operations on the fly, "generate" only writes them to the
+// operation stream file and "replay" executes a previously generated file.
+static const std::string MODE_PROPERTY = "GeneralSettings.mode";
+static const std::string MODE_DEFAULT = "run";
+static const std::string OPERATION_STREAM_PROPERTY = "GeneralSettings.operationstream";
+static const std::string OPERATION_STREAM_DEFAULT = "operations.bin";
+// Run transactions on a BasicClient compiled for the workload's configuration
+// when there is one; false always uses the generic, virtual Client.
+static const std::string SPECIALIZED_CLIENT_PROPERTY = "GeneralSettings.specializedclient";
+static const bool SPECIALIZED_CLIENT_DEFAULT = true;
+
+// Report the heap allocations a client thread made per operation, when counted.
+void LogAllocations(const uint64_t allocations_before, const uint64_t num_ops) {
+  if (utility::AllocationCounter::Enabled() && num_ops > 0) {
+    LOG(INFO) << "# Heap allocations per operation:\t"
+        << static_cast<double>(utility::AllocationCounter::Count() - allocations_before) / num_ops << endl;
+  }
+}
 
 int DelegateClient(std::shared_ptr<DB> db, std::shared_ptr<CoreWorkload> wl, const int num_ops,
-    bool is_loading) {
+    bool is_loading, bool specialized) {
   if (!db) {
     throw Exception("Database is not initilized!");
   }
-  Client client(db, wl);
+  std::unique_ptr<Client> client = CreateClient(db, wl, specialized);
   int oks = 0;
-  for (int i = 0; i < num_ops; ++i) {
-    if (is_loading) {
-      oks += client.DoInsert();
-    } else {
-      oks += client.DoTransaction();
+  uint64_t allocations = utility::AllocationCounter::Count();
+  // A pipelining database gets at least a pipeline's worth of records per batch.
+  const int batch_size = static_cast<int>(std::max(wl->batch_size(), db->pipelineDepth()));
+  if (is_loading && batch_size > 1) {
+    for (int i = 0; i < num_ops; i += batch_size) {
+      oks += client->DoInsertBatch(std::min(batch_size, num_ops - i));
+    }
+  } else if (is_loading) {
+    for (int i = 0; i < num_ops; ++i) {
+      oks += client->DoInsert();
     }
+  } else {
+    oks = client->DoTransactions(num_ops);
   }
+  LogAllocations(allocations, num_ops);
+  wl->AddVerification(client->verification());
   try{
     db->cleanup();
   }
@@ -46,6 +76,43 @@ int DelegateClient(std::shared_ptr<DB> db, std::shared_ptr<CoreWorkload> wl, con
   return oks;
 }
 
+int DelegateReplay(std::shared_ptr<DB> db, std::shared_ptr<CoreWorkload> wl,
+    const OperationRecord *records, const size_t num_ops, const size_t stride, bool specialized) {
+  if (!db) {
+    throw Exception("Database is not initilized!");
+  }
+  std::unique_ptr<Client> client = CreateClient(db, wl, specialized);
+  int oks = 0;
+  uint64_t allocations = utility::AllocationCounter::Count();
+  for (size_t i = 0; i < num_ops; ++i) {
+    oks += client->DoOperation(records[i * stride]);
+  }
+  LogAllocations(allocations, num_ops);
+  wl->AddVerification(client->verification());
+  try{
+    db->cleanup();
+  }
+  catch(const std::exception& e){
+    LOG(WARNING) << e.what() << '\n';
+  }
+  return oks;
+}
+
+uint64_t GenerateOperationStream(CoreWorkload &wl, const std::string &file_name, const uint64_t num_ops) {
+  OperationStreamWriter writer(file_name, wl.value_settings());
+  OperationRecord record;
+  for (uint64_t i = 0; i < num_ops; ++i) {
+    wl.NextOperationRecord(record);
+    if (record.operation == INSERT) {
+      // Later keys may target this insert, as they would in a live run.
+      wl.AcknowledgeInsert(record.keyNum, record.table);
+    }
+    writer.write(record);
+  }
+  writer.close();
+  return writer.count();
+}
+
 int main(const int argc, const char *argv[]) {
   //----------------------------- READING CONFIGURATIONS ---------------------------------------------
 
@@ -82,23 +149,48 @@ int main(const int argc, const char *argv[]) {
   LogExporter logExporter;
   logExporter.flushProperties();
 
+  const std::string mode = localConf.getString(MODE_PROPERTY, MODE_DEFAULT);
+  const std::string stream_file = localConf.getString(OPERATION_STREAM_PROPERTY, OPERATION_STREAM_DEFAULT);
+  if (mode == "generate") {
+    CoreWorkload wl;
+    wl.Init();
+    uint64_t written = GenerateOperationStream(wl, stream_file,
+        localConf.getUInt(CoreWorkload::OPERATION_COUNT_PROPERTY));
+    LOG(INFO) << "# Generated operations:\t" << written << " -> " << stream_file << endl;
+    return 0;
+  } else if (mode != "run" && mode != "replay") {
+    LOG(FATAL) << "Unknown mode " << mode << endl;
+  }
+
   DBFactory dbFactory;
   std::shared_ptr<DB> db = dbFactory.CreateDB();
   if (!db) {
     LOG(FATAL) << "Unknown database name " << localConf.getString("DBSettings.dbname") << endl;
   }
 
+  std::unique_ptr<OperationStreamReader> stream;
+  if (mode == "replay") {
+    // The stream's seed and field lengths make the replayed values those of the generating run.
+    stream.reset(new OperationStreamReader(stream_file));
+  }
   auto wl = make_shared<CoreWorkload>();
+  if (stream) {
+    wl->SetValueSettings(stream->values());
+  }
   wl->Init();
 
   const int num_threads = localConf.getInt("GeneralSettings.numberofthreads", 1);
+  const bool specialized = localConf.getBool(SPECIALIZED_CLIENT_PROPERTY, SPECIALIZED_CLIENT_DEFAULT);
+  const char *key_chooser = SpecializedKeyChooser(*wl);
+  LOG(INFO) << "# Client:\t" << (specialized && key_chooser ? std::string("specialized, ") + key_chooser
+                                                            : std::string("generic")) << endl;
 
-  // Loads data
+  // Loads data, all tables of the workload
   vector<future<int>> actual_ops;
-  unsigned int total_ops = localConf.getUInt(CoreWorkload::RECORD_COUNT_PROPERTY);
+  unsigned int total_ops = wl->TotalRecordCount();
   for (int i = 0; i < num_threads; ++i) {
     actual_ops.emplace_back(std::async(std::launch::async,
-        DelegateClient, db, wl, total_ops / num_threads, true));
+        DelegateClient, db, wl, total_ops / num_threads, true, specialized));
   }
   assert((int)actual_ops.size() == num_threads);
 
@@ -111,12 +203,24 @@ int main(const int argc, const char *argv[]) {
 
   // Peforms transactions
   actual_ops.clear();
-  total_ops = localConf.getUInt(CoreWorkload::RECORD_COUNT_PROPERTY);
+  if (stream) {
+    total_ops = stream->size();
+  } else {
+    // The same count generate writes to a stream, so run and replay match.
+    total_ops = localConf.getUInt(CoreWorkload::OPERATION_COUNT_PROPERTY);
+  }
   utility::Timer<double> timer;
   timer.Start();
   for (int i = 0; i < num_threads; ++i) {
-    actual_ops.emplace_back(std::async(std::launch::async,
-        DelegateClient, db, wl, total_ops / num_threads, false));
+    if (stream) {
+      size_t count;
+      const OperationRecord *records = stream->partition(i, num_threads, count);
+      actual_ops.emplace_back(std::async(std::launch::async,
+          DelegateReplay, db, wl, records, count, num_threads, specialized));
+    } else {
+      actual_ops.emplace_back(std::async(std::launch::async,
+          DelegateClient, db, wl, total_ops / num_threads, false, specialized));
+    }
   }
   assert((int)actual_ops.size() == num_threads);
 
@@ -129,5 +233,14 @@ int main(const int argc, const char *argv[]) {
   LOG(INFO) << "# Transaction throughput (KTPS)" << endl;
   LOG(INFO) << localConf.getString("DBSettings.dbname") << '\t'; //<< file_name << '\t' << num_threads << '\t';
   LOG(INFO) << total_ops / duration / 1000 << endl;
+  if (stream) {
+    // Includes reads whose thread got ahead of the insert of their key.
+    LOG(INFO) << "# Replayed operations failed:\t" << total_ops - sum << endl;
+  }
+  if (wl->data_integrity()) {
+    utility::VerificationCounts verification = wl->Verification();
+    LOG(INFO) << "# Values verified/stale/corrupt:\t" << verification.verified << '\t'
+        << verification.stale << '\t' << verification.corrupt << endl;
+  }
 }
 
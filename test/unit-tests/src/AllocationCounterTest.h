@@ -0,0 +1,55 @@
+// AllocationCounterTest.h
+
+#ifndef _DBBENCHMARK_ALLOCATIONCOUNTERTEST_H_
+#define _DBBENCHMARK_ALLOCATIONCOUNTERTEST_H_
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "Core/Record.h"
+#include "Core/Utility/AllocationCounter.h"
+
+using namespace dbbenchmark::utility;
+
+namespace test {
+namespace allocationcountertest {
+
+class AllocationCounterTest  : public ::testing::Test {
+	virtual void SetUp() { return; }
+	virtual void TearDown() { return; }
+};
+
+TEST_F(AllocationCounterTest, CountsNew) {
+	if (!AllocationCounter::Enabled()) {
+		ASSERT_EQ(0u, AllocationCounter::Count());
+		return;
+	}
+	uint64_t before = AllocationCounter::Count();
+	std::unique_ptr<int> single(new int(1));
+	std::unique_ptr<int[]> array(new int[8]);
+	ASSERT_EQ(before + 2, AllocationCounter::Count());
+}
+
+TEST_F(AllocationCounterTest, ClearedScratchDoesNotAllocate) {
+	if (!AllocationCounter::Enabled()) {
+		return;
+	}
+	std::vector<dbbenchmark::FieldValue> values;
+	values.reserve(10);
+	uint64_t before = AllocationCounter::Count();
+	for (int op = 0; op < 1000; op++) {
+		values.clear();
+		for (int i = 0; i < 10; i++) {
+			values.push_back({std::string_view("field"), std::string_view("value")});
+		}
+	}
+	ASSERT_EQ(before, AllocationCounter::Count());
+}
+
+} // namespace allocationcountertest
+} // namespace test
+
+#endif // _DBBENCHMARK_ALLOCATIONCOUNTERTEST_H_
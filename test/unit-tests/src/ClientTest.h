@@ -0,0 +1,258 @@
+// ClientTest.h
+
+#ifndef _DBBENCHMARK_CLIENTTEST_H_
+#define _DBBENCHMARK_CLIENTTEST_H_
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Core/Client.h"
+#include "Core/Utility/AllocationCounter.h"
+#include "Utility/WorkloadTestHelper.h"
+
+using namespace dbbenchmark::workloads;
+
+namespace test {
+namespace clienttest {
+
+///
+/// A CoreWorkload that keeps the key of every insert reported as done.
+///
+class AcknowledgingWorkload : public CoreWorkload {
+public:
+	void AcknowledgeInsert(uint64_t key_num, std::size_t table = 0) override {
+		acknowledged.push_back(key_num);
+		CoreWorkload::AcknowledgeInsert(key_num, table);
+	}
+	std::vector<uint64_t> acknowledged;
+};
+
+class ClientTest : public ::testing::Test {
+public:
+	ClientTest() : db(std::make_shared<workloadtesthelper::RecordingDB>()),
+	               workload(std::make_shared<CoreWorkload>()) {
+		settings.set("recordcount", "100");
+		settings.set("operationcount", "1000");
+		settings.set("fieldcount", "4");
+		settings.set("fieldlength", "100");
+	}
+	~ClientTest() override { }
+	workloadtesthelper::ScopedSettings settings;
+	std::shared_ptr<workloadtesthelper::RecordingDB> db;
+	std::shared_ptr<CoreWorkload> workload;
+};
+
+TEST_F(ClientTest, TransactionsDoNotAllocateOnceWarm) {
+	if (!dbbenchmark::utility::AllocationCounter::Enabled()) {
+		return;
+	}
+	settings.set("readproportion", "0.3");
+	settings.set("updateproportion", "0.2");
+	settings.set("scanproportion", "0.3");
+	settings.set("readmodifywriteproportion", "0.2");
+	settings.set("maxscanlength", "5");
+	settings.set("readallfields", "true");
+	workload->Init();
+	db->recording = false;
+	db->resultFields = 4;
+	dbbenchmark::Client client(db, workload);
+	// The first transactions grow the client's buffers to the largest read and scan.
+	for (int i = 0; i < 500; ++i) {
+		client.DoTransaction();
+	}
+	uint64_t before = dbbenchmark::utility::AllocationCounter::Count();
+	for (int i = 0; i < 1000; ++i) {
+		ASSERT_TRUE(client.DoTransaction());
+	}
+	ASSERT_EQ(before, dbbenchmark::utility::AllocationCounter::Count());
+}
+
+TEST_F(ClientTest, TransactionDelete) {
+	settings.set("readproportion", "0");
+	settings.set("updateproportion", "0");
+	settings.set("deleteproportion", "1");
+	workload->Init();
+	dbbenchmark::Client client(db, workload);
+	ASSERT_TRUE(client.DoTransaction());
+	db->failingKeys.push_back(workload->BuildKeyName(1));
+	ASSERT_FALSE(client.DoTransaction());
+	ASSERT_EQ(2u, db->calls.size());
+	for (uint64_t i = 0; i < 2; ++i) {
+		EXPECT_EQ(dbbenchmark::DBOperation::DELETE, db->calls[i].type);
+		EXPECT_EQ(workload->TableName(0), db->calls[i].table);
+		EXPECT_EQ(workload->BuildKeyName(i), db->calls[i].key);
+	}
+}
+
+TEST_F(ClientTest, InsertBatchesSplitAtTables) {
+	settings.set("tables", "a, b");
+	settings.set("table.a.recordcount", "3");
+	settings.set("table.b.recordcount", "4");
+	settings.set("dataintegrity", "true");
+	workload->Init();
+	dbbenchmark::Client client(db, workload);
+	ASSERT_EQ(5, client.DoInsertBatch(5));
+	ASSERT_EQ(2, client.DoInsertBatch(2));
+	ASSERT_EQ(3u, db->batches.size());
+	EXPECT_EQ(std::make_pair(std::string("a"), std::size_t(3)), db->batches[0]);
+	EXPECT_EQ(std::make_pair(std::string("b"), std::size_t(2)), db->batches[1]);
+	EXPECT_EQ(std::make_pair(std::string("b"), std::size_t(2)), db->batches[2]);
+	// Every record got its own key and the fields BuildValues() makes for it.
+	const std::size_t tables[] = {0, 0, 0, 1, 1, 1, 1};
+	const uint64_t keys[] = {0, 1, 2, 0, 1, 2, 3};
+	ASSERT_EQ(7u, db->calls.size());
+	std::vector<dbbenchmark::FieldValue> expected;
+	for (std::size_t i = 0; i < db->calls.size(); ++i) {
+		const workloadtesthelper::RecordedCall &call = db->calls[i];
+		EXPECT_EQ(dbbenchmark::DBOperation::INSERT, call.type);
+		EXPECT_EQ(workload->TableName(tables[i]), call.table);
+		EXPECT_EQ(workload->BuildKeyName(keys[i]), call.key);
+		expected.clear();
+		workload->BuildValues(expected, tables[i], keys[i]);
+		ASSERT_EQ(expected.size(), call.values.size());
+		for (std::size_t j = 0; j < expected.size(); ++j) {
+			EXPECT_EQ(expected[j].field, call.values[j].first);
+			EXPECT_EQ(expected[j].value, call.values[j].second);
+		}
+	}
+}
+
+TEST_F(ClientTest, FailedInsertBatchCountsNothing) {
+	workload->Init();
+	db->failingKeys.push_back(workload->BuildKeyName(1));
+	dbbenchmark::Client client(db, workload);
+	ASSERT_EQ(0, client.DoInsertBatch(3));
+	ASSERT_EQ(3, client.DoInsertBatch(3));
+	// The default batchInsert() still tries every record of the failed batch.
+	ASSERT_EQ(6u, db->calls.size());
+}
+
+TEST_F(ClientTest, DefaultBatchInsertReportsTheLastError) {
+	std::vector<dbbenchmark::FieldValue> values(1, dbbenchmark::FieldValue{"field0", "value"});
+	std::vector<dbbenchmark::KeyedRecord> records;
+	for (const char *key : {"user0", "user1", "user2"}) {
+		records.push_back({key, dbbenchmark::RecordView(values)});
+	}
+	ASSERT_EQ(dbbenchmark::utility::Status::OK, db->batchInsert("usertable", records));
+	db->failingKeys.push_back("user1");
+	ASSERT_EQ(dbbenchmark::utility::Status::ERROR, db->batchInsert("usertable", records));
+	ASSERT_EQ(6u, db->calls.size());
+	EXPECT_EQ("user2", db->calls.back().key);
+	EXPECT_EQ("value", db->calls.back().values[0].second);
+}
+
+TEST_F(ClientTest, WindowStatusesFollowTheirRecords) {
+	settings.set("readproportion", "0.3");
+	settings.set("updateproportion", "0");
+	settings.set("readmodifywriteproportion", "0.3");
+	settings.set("scanproportion", "0.1");
+	settings.set("deleteproportion", "0.1");
+	settings.set("insertproportion", "0.2");
+	settings.set("maxscanlength", "3");
+	std::shared_ptr<AcknowledgingWorkload> acknowledging = std::make_shared<AcknowledgingWorkload>();
+	acknowledging->Init();
+	db->depth = 8;
+	dbbenchmark::Client client(db, acknowledging);
+	const dbbenchmark::DBOperation::Type failing[] = {
+		dbbenchmark::DBOperation::READ, dbbenchmark::DBOperation::UPDATE, dbbenchmark::DBOperation::INSERT};
+	for (dbbenchmark::DBOperation::Type type : failing) {
+		db->calls.clear();
+		db->failingTypes.assign(1, type);
+		acknowledging->acknowledged.clear();
+		int oks = client.DoTransactions(400);
+		// Without plain updates every UPDATE is the write of a read-modify-write, right after its READ.
+		std::size_t counts[5] = {0, 0, 0, 0, 0};
+		std::vector<std::string> inserted;
+		for (std::size_t i = 0; i < db->calls.size(); ++i) {
+			const workloadtesthelper::RecordedCall &call = db->calls[i];
+			++counts[call.type];
+			if (call.type == dbbenchmark::DBOperation::UPDATE) {
+				ASSERT_LT(0u, i);
+				ASSERT_EQ(dbbenchmark::DBOperation::READ, db->calls[i - 1].type);
+				ASSERT_EQ(db->calls[i - 1].key, call.key);
+				ASSERT_FALSE(call.values.empty());
+			} else if (call.type == dbbenchmark::DBOperation::INSERT) {
+				inserted.push_back(call.key);
+			}
+		}
+		const std::size_t rmws = counts[dbbenchmark::DBOperation::UPDATE];
+		ASSERT_EQ(400u, db->calls.size() - rmws);
+		ASSERT_LT(0u, rmws);
+		ASSERT_LT(0u, counts[dbbenchmark::DBOperation::SCAN]);
+		ASSERT_LT(0u, counts[dbbenchmark::DBOperation::DELETE]);
+		ASSERT_LT(0u, inserted.size());
+		// A read-modify-write counts by its write: failed reads only fail plain reads.
+		std::size_t failed = counts[type];
+		if (type == dbbenchmark::DBOperation::READ) {
+			failed -= rmws;
+		}
+		EXPECT_EQ(static_cast<int>(400 - failed), oks);
+		// Inserts are acknowledged whether they succeeded or not.
+		ASSERT_EQ(inserted.size(), acknowledging->acknowledged.size());
+		for (std::size_t i = 0; i < inserted.size(); ++i) {
+			EXPECT_EQ(inserted[i], acknowledging->BuildKeyName(acknowledging->acknowledged[i]));
+		}
+	}
+}
+
+TEST_F(ClientTest, ReplayWritesTheSameBytes) {
+	const std::string fileName = "client_replay_test.bin";
+	settings.set("field_len_dist", "zipfian");
+	settings.set("readproportion", "0.2");
+	settings.set("updateproportion", "0.4");
+	settings.set("insertproportion", "0.4");
+	for (const char *payload : {"ascii", "counter"}) {
+		settings.set("payloadtype", payload);
+		workload->Init();
+		{
+			OperationStreamWriter writer(fileName, workload->value_settings());
+			OperationRecord record;
+			for (int i = 0; i < 200; ++i) {
+				workload->NextOperationRecord(record);
+				if (record.operation == INSERT) {
+					workload->AcknowledgeInsert(record.keyNum, record.table);
+				}
+				writer.write(record);
+			}
+		}
+		OperationStreamReader reader(fileName);
+		auto replay = [&reader](std::vector<workloadtesthelper::RecordedCall> &calls) {
+			std::shared_ptr<workloadtesthelper::RecordingDB> replay_db =
+					std::make_shared<workloadtesthelper::RecordingDB>();
+			std::shared_ptr<CoreWorkload> replay_workload = std::make_shared<CoreWorkload>();
+			replay_workload->SetValueSettings(reader.values());
+			replay_workload->Init();
+			dbbenchmark::Client client(replay_db, replay_workload);
+			for (uint64_t i = 0; i < reader.size(); ++i) {
+				client.DoOperation(reader.records()[i]);
+			}
+			calls = replay_db->calls;
+		};
+		// Each thread has its own value pools, so the second replay runs in another one.
+		std::vector<workloadtesthelper::RecordedCall> first, second;
+		replay(first);
+		std::thread other(replay, std::ref(second));
+		other.join();
+		ASSERT_EQ(200u, first.size());
+		ASSERT_EQ(first.size(), second.size());
+		std::size_t written = 0;
+		for (std::size_t i = 0; i < first.size(); ++i) {
+			EXPECT_EQ(first[i].type, second[i].type);
+			EXPECT_EQ(first[i].key, second[i].key);
+			ASSERT_EQ(first[i].values, second[i].values) << payload << " call " << i;
+			written += first[i].values.size();
+		}
+		EXPECT_LT(0u, written);
+	}
+	std::remove(fileName.c_str());
+}
+
+} // namespace clienttest
+} // namespace test
+
+#endif // _DBBENCHMARK_CLIENTTEST_H_
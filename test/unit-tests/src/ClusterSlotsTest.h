@@ -0,0 +1,57 @@
+// ClusterSlotsTest.h
+
+#ifndef _DBBENCHMARK_CLUSTERSLOTSTEST_H_
+#define _DBBENCHMARK_CLUSTERSLOTSTEST_H_
+
+#include <gtest/gtest.h>
+
+#include "Redis/ClusterSlots.h"
+
+using namespace dbbenchmark::redisdb;
+
+namespace test {
+namespace clusterslotstest {
+
+class ClusterSlotsTest  : public ::testing::Test {
+	virtual void SetUp() { return; }
+	virtual void TearDown() { return; }
+};
+
+TEST_F(ClusterSlotsTest, Crc16CheckValue) {
+	EXPECT_EQ(0x31C3, Crc16("123456789"));
+	EXPECT_EQ(0, Crc16(""));
+}
+
+TEST_F(ClusterSlotsTest, KeySlotMatchesRedis) {
+	EXPECT_EQ(12182, KeySlot("foo"));
+	EXPECT_EQ(5061, KeySlot("bar"));
+	EXPECT_EQ(866, KeySlot("hello"));
+}
+
+TEST_F(ClusterSlotsTest, HashTags) {
+	EXPECT_EQ(KeySlot("user1000"), KeySlot("{user1000}.following"));
+	EXPECT_EQ(KeySlot("bar"), KeySlot("foo{bar}{zap}"));
+	// An empty tag hashes the whole key, a second '{' is part of the tag.
+	EXPECT_EQ(Crc16("foo{}{bar}") & (CLUSTER_SLOTS - 1), KeySlot("foo{}{bar}"));
+	EXPECT_EQ(KeySlot("{bar"), KeySlot("foo{{bar}}zap"));
+}
+
+TEST_F(ClusterSlotsTest, ParseRedirect) {
+	Redirect redirect;
+	ASSERT_TRUE(ParseRedirect("MOVED 3999 127.0.0.1:6381", redirect));
+	EXPECT_FALSE(redirect.ask);
+	EXPECT_EQ(3999, redirect.slot);
+	EXPECT_EQ("127.0.0.1:6381", redirect.address);
+	ASSERT_TRUE(ParseRedirect("ASK 12182 node2:7000", redirect));
+	EXPECT_TRUE(redirect.ask);
+	EXPECT_EQ(12182, redirect.slot);
+	EXPECT_EQ("node2:7000", redirect.address);
+	EXPECT_FALSE(ParseRedirect("ERR wrong number of arguments", redirect));
+	EXPECT_FALSE(ParseRedirect("MOVED 16384 node:1", redirect));
+	EXPECT_FALSE(ParseRedirect("MOVED 12", redirect));
+}
+
+} // namespace clusterslotstest
+} // namespace test
+
+#endif // _DBBENCHMARK_CLUSTERSLOTSTEST_H_
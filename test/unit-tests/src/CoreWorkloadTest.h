@@ -31,13 +31,13 @@ CoreWorkloadTest() {
 };
 
 TEST_F(CoreWorkloadTest, BuildValues) {
-	std::vector<stringPair> values;
+	std::vector<dbbenchmark::FieldValue> values;
 	this->coreworkload->BuildValues(values);
 	EXPECT_EQ(numberOfFiledsGenerated, values.size());
 }
 
 TEST_F(CoreWorkloadTest, BuildUpdate) {
-	std::vector<stringPair> update;
+	std::vector<dbbenchmark::FieldValue> update;
 	this->coreworkload->BuildUpdate(update);
 	EXPECT_EQ(1, update.size());
 }
@@ -0,0 +1,113 @@
+// DataIntegrityTest.h
+
+#ifndef _DBBENCHMARK_DATAINTEGRITYTEST_H_
+#define _DBBENCHMARK_DATAINTEGRITYTEST_H_
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+
+#include "Core/Utility/DataIntegrity.h"
+
+using namespace dbbenchmark::utility;
+
+namespace test {
+namespace dataintegritytest {
+
+class DataIntegrityTest  : public ::testing::Test {
+	virtual void SetUp() { return; }
+	virtual void TearDown() { return; }
+};
+
+static std::string MakeValue(std::size_t length, uint64_t key_num, uint64_t field_id, uint64_t version,
+                             bool binary = false) {
+	std::string value(length, '\0');
+	DeterministicValue::Fill(&value[0], length, key_num, field_id, version, binary);
+	return value;
+}
+
+TEST_F(DataIntegrityTest, SameInputsSameValue) {
+	EXPECT_EQ(MakeValue(100, 7, 3, 12), MakeValue(100, 7, 3, 12));
+	EXPECT_NE(MakeValue(100, 7, 3, 12), MakeValue(100, 8, 3, 12));
+	EXPECT_NE(MakeValue(100, 7, 3, 12), MakeValue(100, 7, 4, 12));
+	EXPECT_NE(MakeValue(100, 7, 3, 12), MakeValue(100, 7, 3, 13));
+}
+
+TEST_F(DataIntegrityTest, PrintableUnlessBinary) {
+	std::string value = MakeValue(4096, 1, 0, 0);
+	for(char c : value) {
+		ASSERT_TRUE(c >= '!' && c <= '~');
+	}
+	std::string binary = MakeValue(4096, 1, 0, 0, true);
+	bool unprintable = false;
+	for(std::size_t i = DeterministicValue::kHeaderSize; i < binary.size(); i++) {
+		unprintable |= (binary[i] < '!' || binary[i] > '~');
+	}
+	EXPECT_TRUE(unprintable);
+}
+
+TEST_F(DataIntegrityTest, VerifiesAndRecoversVersion) {
+	const std::size_t lengths[] = {DeterministicValue::kHeaderSize, 9, 16, 100, 1001};
+	for(std::size_t length : lengths) {
+		for(bool binary : {false, true}) {
+			uint64_t version = 0;
+			EXPECT_TRUE(DeterministicValue::Verify(MakeValue(length, 42, 5, 123456, binary), 42, 5, binary, version));
+			EXPECT_EQ(123456u, version);
+		}
+	}
+	uint64_t version = 0;
+	EXPECT_TRUE(DeterministicValue::Verify(MakeValue(20, 1, 1, DeterministicValue::kMaxVersion), 1, 1, false, version));
+	EXPECT_EQ(DeterministicValue::kMaxVersion, version);
+}
+
+TEST_F(DataIntegrityTest, DetectsCorruption) {
+	uint64_t version;
+	std::string value = MakeValue(100, 42, 5, 9);
+	EXPECT_FALSE(DeterministicValue::Verify(value, 43, 5, false, version));
+	EXPECT_FALSE(DeterministicValue::Verify(value, 42, 6, false, version));
+	EXPECT_FALSE(DeterministicValue::Verify(value.substr(0, 4), 42, 5, false, version));
+	for(std::size_t i = 0; i < value.size(); i++) {
+		std::string flipped = value;
+		flipped[i] ^= 1;
+		ASSERT_FALSE(DeterministicValue::Verify(flipped, 42, 5, false, version)) << i;
+	}
+}
+
+TEST_F(DataIntegrityTest, ArenaKeepsEarlierValues) {
+	ValueArena arena;
+	char *first = arena.Allocate(16);
+	std::fill(first, first + 16, 'a');
+	for(int i = 0; i < 100; i++) {
+		std::fill_n(arena.Allocate(ValueArena::kBlockSize / 8), ValueArena::kBlockSize / 8, 'b');
+	}
+	EXPECT_EQ(std::string(16, 'a'), std::string(first, 16));
+	arena.Reset();
+	EXPECT_EQ(first, arena.Allocate(16));
+}
+
+TEST_F(DataIntegrityTest, WriteVersionCache) {
+	WriteVersionCache cache;
+	EXPECT_EQ(0u, cache.Expected(0, 10, 2));
+	cache.Record(0, 10, 2, 7);
+	EXPECT_EQ(7u, cache.Expected(0, 10, 2));
+	EXPECT_EQ(0u, cache.Expected(0, 10, 3));
+	EXPECT_EQ(0u, cache.Expected(1, 10, 2));
+	cache.Record(0, 10, WriteVersionCache::kAllFields, 8);
+	EXPECT_EQ(8u, cache.Expected(0, 10, 3));
+}
+
+TEST_F(DataIntegrityTest, VersionsHoldWriterAndSequence) {
+	uint64_t version = DeterministicValue::Version(3, 17);
+	EXPECT_EQ(3u, DeterministicValue::Writer(version));
+	EXPECT_EQ(17u, DeterministicValue::Sequence(version));
+	EXPECT_GE(DeterministicValue::kMaxVersion, DeterministicValue::Version(DeterministicValue::kMaxWriter + 5,
+	                                                                      DeterministicValue::kMaxSequence));
+	uint64_t read = 0;
+	EXPECT_TRUE(DeterministicValue::Verify(MakeValue(20, 1, 1, version), 1, 1, false, read));
+	EXPECT_EQ(version, read);
+}
+
+} // namespace dataintegritytest
+} // namespace test
+
+#endif // _DBBENCHMARK_DATAINTEGRITYTEST_H_
@@ -0,0 +1,72 @@
+// AcknowledgedCounterGeneratorTest.h
+
+#ifndef _DBBENCHMARK_ACKNOWLEDGEDCOUNTERGENERATORTEST_H_
+#define _DBBENCHMARK_ACKNOWLEDGEDCOUNTERGENERATORTEST_H_
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "Core/Generators/AcknowledgedCounterGenerator.h"
+
+using namespace dbbenchmark::generators;
+
+namespace test {
+namespace acknowledgedcountergeneratortest {
+
+class AcknowledgedCounterGeneratorTest  : public ::testing::TestWithParam<uint64_t> {
+	virtual void SetUp() { return; }
+	virtual void TearDown() { return; }
+};
+
+TEST_P(AcknowledgedCounterGeneratorTest, LastFollowsAcknowledged) {
+	AcknowledgedCounterGenerator generator(GetParam());
+	EXPECT_EQ(GetParam() - 1, generator.Last());
+	uint64_t first = generator.Next();
+	uint64_t second = generator.Next();
+	EXPECT_EQ(GetParam() - 1, generator.Last());
+	generator.Acknowledge(second);
+	EXPECT_EQ(GetParam() - 1, generator.Last());
+	generator.Acknowledge(first);
+	EXPECT_EQ(second, generator.Last());
+}
+
+TEST_P(AcknowledgedCounterGeneratorTest, Set) {
+	AcknowledgedCounterGenerator generator(0);
+	generator.Set(GetParam());
+	EXPECT_EQ(GetParam() - 1, generator.Last());
+	uint64_t value = generator.Next();
+	EXPECT_EQ(GetParam(), value);
+	generator.Acknowledge(value);
+	EXPECT_EQ(GetParam(), generator.Last());
+}
+
+TEST_F(AcknowledgedCounterGeneratorTest, ConcurrentAcknowledge) {
+	AcknowledgedCounterGenerator generator(100);
+	const int numThreads = 4;
+	const int perThread = 10000;
+	std::vector<std::thread> threads;
+	for(int t = 0; t < numThreads; t++) {
+		threads.emplace_back([&generator]() {
+			for(int i = 0; i < perThread; i++)
+				generator.Acknowledge(generator.Next());
+		});
+	}
+	for(auto &thread : threads)
+		thread.join();
+	EXPECT_EQ(static_cast<uint64_t>(100 + numThreads * perThread - 1), generator.Last());
+}
+
+TEST_F(AcknowledgedCounterGeneratorTest, WindowOverflow) {
+	AcknowledgedCounterGenerator generator(0);
+	EXPECT_THROW(generator.Acknowledge(AcknowledgedCounterGenerator::kWindowSize + 1),
+		dbbenchmark::utility::IllegalStateException);
+}
+
+INSTANTIATE_TEST_CASE_P(InstantiationName, AcknowledgedCounterGeneratorTest, ::testing::Values(static_cast<uint64_t>(1), static_cast<uint64_t>(2),
+						static_cast<uint64_t>(12345)));
+
+} // namespace acknowledgedcountergeneratortest
+} // namespace test
+
+#endif // _DBBENCHMARK_ACKNOWLEDGEDCOUNTERGENERATORTEST_H_
@@ -35,6 +35,16 @@ TEST_P(CounterGeneratorTest, Set) {
 	EXPECT_EQ(GetParam(), generator.Next());
 }
 
+TEST_P(CounterGeneratorTest, NextBatch) {
+	CounterGenerator generator(GetParam());
+	uint64_t values[11];
+	generator.NextBatch(values, 11);
+	for(uint64_t i = 0; i < 11; i++)
+		EXPECT_EQ(GetParam() + i, values[i]);
+	EXPECT_EQ(GetParam() + 10, generator.Last());
+	EXPECT_EQ(GetParam() + 11, generator.Next());
+}
+
 INSTANTIATE_TEST_CASE_P(InstantiationName, CounterGeneratorTest, ::testing::Values(static_cast<uint64_t>(0), static_cast<uint64_t>(2),
 						static_cast<uint64_t>(12345)));
 
@@ -0,0 +1,72 @@
+// DriftingGeneratorTest.h
+
+#ifndef _DBBENCHMARK_DRIFTINGGENERATORTEST_H_
+#define _DBBENCHMARK_DRIFTINGGENERATORTEST_H_
+
+#include <gtest/gtest.h>
+#include "Core/Generators/ConstGenerator.h"
+#include "Core/Generators/DriftingGenerator.h"
+#include "Core/Generators/HotspotGenerator.h"
+
+using namespace dbbenchmark::generators;
+
+namespace test {
+namespace driftinggeneratortest {
+
+class DriftingGeneratorTest  : public ::testing::Test {
+	virtual void SetUp() { return; }
+	virtual void TearDown() { return; }
+};
+
+TEST_F(DriftingGeneratorTest, StepShift) {
+	DriftingGenerator generator(new ConstGenerator(10), 10, 109, 5, 30, DriftingGenerator::STEP);
+	for(int i = 0; i < 5; i++)
+		EXPECT_EQ(10u, generator.Next());
+	for(int i = 0; i < 5; i++)
+		EXPECT_EQ(40u, generator.Next());
+	EXPECT_EQ(40u, generator.Last());
+	for(int i = 0; i < 10; i++)
+		generator.Next();
+	// Fourth step wraps around the end of the keyspace.
+	EXPECT_EQ(10u + 120 % 100, generator.Next());
+}
+
+TEST_F(DriftingGeneratorTest, ContinuousShift) {
+	DriftingGenerator generator(new ConstGenerator(0), 0, 999, 10, 100, DriftingGenerator::CONTINUOUS);
+	for(uint64_t i = 0; i < 30; i++)
+		EXPECT_EQ(i * 10, generator.Next());
+}
+
+TEST_F(DriftingGeneratorTest, NextBatchMatchesNext) {
+	DriftingGenerator single(new ConstGenerator(3), 0, 99, 7, 13, DriftingGenerator::CONTINUOUS);
+	DriftingGenerator batch(new ConstGenerator(3), 0, 99, 7, 13, DriftingGenerator::CONTINUOUS);
+	uint64_t values[50];
+	batch.NextBatch(values, 50);
+	for(int i = 0; i < 50; i++)
+		EXPECT_EQ(single.Next(), values[i]);
+	EXPECT_EQ(values[49], batch.Last());
+}
+
+TEST_F(DriftingGeneratorTest, HotspotStaysInRange) {
+	DriftingGenerator generator(new HotspotGenerator(100, 199, 0.2, 0.8), 100, 199, 1000, 50,
+		DriftingGenerator::STEP);
+	int hot = 0;
+	for(int i = 0; i < 2000; i++) {
+		uint64_t value = generator.Next();
+		EXPECT_TRUE(value >= 100 && value <= 199);
+		// The hot set [100, 120) has moved to [150, 170) after the first step.
+		if(i >= 1000 && value >= 150 && value < 170)
+			hot++;
+	}
+	EXPECT_NEAR(0.8, hot / 1000.0, 0.05);
+}
+
+TEST_F(DriftingGeneratorTest, BadArguments) {
+	EXPECT_THROW(DriftingGenerator(new ConstGenerator(0), 0, 9, 0, 1, DriftingGenerator::STEP),
+		dbbenchmark::utility::InvalidArgumentException);
+}
+
+} // namespace driftinggeneratortest
+} // namespace test
+
+#endif // _DBBENCHMARK_DRIFTINGGENERATORTEST_H_
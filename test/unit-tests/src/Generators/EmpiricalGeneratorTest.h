@@ -0,0 +1,74 @@
+// EmpiricalGeneratorTest.h
+
+#ifndef _DBBENCHMARK_EMPIRICALGENERATORTEST_H_
+#define _DBBENCHMARK_EMPIRICALGENERATORTEST_H_
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <vector>
+
+#include "Core/Generators/EmpiricalGenerator.h"
+
+using namespace dbbenchmark::generators;
+
+namespace test {
+namespace empiricalgeneratortest {
+
+class EmpiricalGeneratorTest  : public ::testing::Test {
+public:
+	const std::string fileName = "empirical_generator_test.hist";
+
+	void WriteHistogram(uint32_t kind, const std::vector<EmpiricalGenerator::Entry> &entries) {
+		EmpiricalGenerator::Header header;
+		std::memcpy(header.magic, "DBBHIST1", sizeof(header.magic));
+		header.kind = kind;
+		header.reserved = 0;
+		header.count = entries.size();
+		std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(EmpiricalGenerator::Entry));
+	}
+	virtual void TearDown() { std::remove(fileName.c_str()); }
+};
+
+TEST_F(EmpiricalGeneratorTest, Histogram) {
+	WriteHistogram(EmpiricalGenerator::HISTOGRAM, {{100, 6.0}, {7, 0.0}, {42, 3.0}, {5, 1.0}});
+	EmpiricalGenerator generator(fileName);
+	EXPECT_EQ(4u, generator.size());
+	std::map<uint64_t, int> counts;
+	for(int i = 0; i < 100000; i++)
+		counts[generator.Next()]++;
+	EXPECT_EQ(0, counts.count(7));
+	EXPECT_EQ(3u, counts.size());
+	EXPECT_NEAR(0.6, counts[100] / 100000.0, 0.01);
+	EXPECT_NEAR(0.3, counts[42] / 100000.0, 0.01);
+	EXPECT_NEAR(0.1, counts[5] / 100000.0, 0.01);
+}
+
+TEST_F(EmpiricalGeneratorTest, Cdf) {
+	WriteHistogram(EmpiricalGenerator::CDF, {{1, 0.5}, {2, 0.5}, {3, 1.0}});
+	EmpiricalGenerator generator(fileName);
+	uint64_t values[20000];
+	generator.NextBatch(values, 20000);
+	int ones = 0;
+	for(int i = 0; i < 20000; i++) {
+		EXPECT_NE(2u, values[i]);
+		ones += (values[i] == 1);
+	}
+	EXPECT_NEAR(0.5, ones / 20000.0, 0.02);
+	EXPECT_EQ(values[19999], generator.Last());
+}
+
+TEST_F(EmpiricalGeneratorTest, BadFile) {
+	WriteHistogram(EmpiricalGenerator::CDF, {{1, 0.5}, {2, 0.2}});
+	EXPECT_THROW(EmpiricalGenerator generator(fileName), dbbenchmark::utility::DataException);
+	EXPECT_THROW(EmpiricalGenerator generator("does_not_exist.hist"), dbbenchmark::utility::FileException);
+}
+
+} // namespace empiricalgeneratortest
+} // namespace test
+
+#endif // _DBBENCHMARK_EMPIRICALGENERATORTEST_H_
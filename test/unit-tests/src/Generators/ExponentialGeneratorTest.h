@@ -0,0 +1,46 @@
+// ExponentialGeneratorTest.h
+
+#ifndef _DBBENCHMARK_EXPONENTIALGENERATORTEST_H_
+#define _DBBENCHMARK_EXPONENTIALGENERATORTEST_H_
+
+#include <gtest/gtest.h>
+#include "Core/Generators/ExponentialGenerator.h"
+
+using namespace dbbenchmark::generators;
+
+namespace test {
+namespace exponentialgeneratortest {
+
+class ExponentialGeneratorTest  : public ::testing::Test {
+public:
+	virtual void SetUp() { }
+	virtual void TearDown() { }
+};
+
+TEST_F(ExponentialGeneratorTest, LastValue) {
+	ExponentialGenerator generator(10.0);
+	auto value = generator.Next();
+	EXPECT_EQ(value, generator.Last());
+}
+
+TEST_F(ExponentialGeneratorTest, Percentile) {
+	// 95% of the values must fall below 1000.
+	ExponentialGenerator generator(95.0, 1000.0);
+	uint64_t values[10000];
+	generator.NextBatch(values, 10000);
+	int below = 0;
+	for(int i = 0; i < 10000; i++)
+		below += (values[i] < 1000);
+	EXPECT_NEAR(0.95, below / 10000.0, 0.02);
+	EXPECT_EQ(values[9999], generator.Last());
+}
+
+TEST_F(ExponentialGeneratorTest, Mean) {
+	ExponentialGenerator generator(50.0);
+	EXPECT_DOUBLE_EQ(50.0, generator.mean());
+}
+
+} // namespace exponentialgeneratortest
+} // namespace test
+
+#endif // _DBBENCHMARK_EXPONENTIALGENERATORTEST_H_
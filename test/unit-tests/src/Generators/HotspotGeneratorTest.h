@@ -0,0 +1,73 @@
+// HotspotGeneratorTest.h
+
+#ifndef _DBBENCHMARK_HOTSPOTGENERATORTEST_H_
+#define _DBBENCHMARK_HOTSPOTGENERATORTEST_H_
+
+#include <gtest/gtest.h>
+#include "Core/Generators/HotspotGenerator.h"
+
+using namespace dbbenchmark::generators;
+
+namespace test {
+namespace hotspotgeneratortest {
+
+::testing::AssertionResult IsBetweenInclusive(uint64_t val, uint64_t a, uint64_t b) {
+	if((val >= a) && (val <= b))
+		return ::testing::AssertionSuccess();
+	else
+		return ::testing::AssertionFailure()
+			<< val << " is outside the range " << a << " to " << b;
+}
+
+class HotspotGeneratorTest  : public ::testing::TestWithParam<std::pair<uint64_t,uint64_t>> {
+	virtual void SetUp() { return; }
+	virtual void TearDown() { return; }
+};
+
+TEST_P(HotspotGeneratorTest, NextValue) {
+	HotspotGenerator generator(std::get<0>(GetParam()), std::get<1>(GetParam()), 0.2, 0.8);
+	for(int i = 0; i < 100; i++) {
+		auto value = generator.Next();
+		EXPECT_TRUE(IsBetweenInclusive(value, std::get<0>(GetParam()), std::get<1>(GetParam())));
+		EXPECT_EQ(value, generator.Last());
+	}
+}
+
+TEST_P(HotspotGeneratorTest, NextBatch) {
+	HotspotGenerator generator(std::get<0>(GetParam()), std::get<1>(GetParam()), 0.2, 0.8);
+	uint64_t values[64];
+	generator.NextBatch(values, 64);
+	for(int i = 0; i < 64; i++)
+		EXPECT_TRUE(IsBetweenInclusive(values[i], std::get<0>(GetParam()), std::get<1>(GetParam())));
+	EXPECT_EQ(values[63], generator.Last());
+}
+
+TEST_F(HotspotGeneratorTest, OnlyHotSet) {
+	HotspotGenerator generator(0, 99, 0.1, 1.0);
+	for(int i = 0; i < 1000; i++)
+		EXPECT_TRUE(IsBetweenInclusive(generator.Next(), 0, 9));
+}
+
+TEST_F(HotspotGeneratorTest, OnlyColdSet) {
+	HotspotGenerator generator(0, 99, 0.1, 0.0);
+	for(int i = 0; i < 1000; i++)
+		EXPECT_TRUE(IsBetweenInclusive(generator.Next(), 10, 99));
+}
+
+TEST_F(HotspotGeneratorTest, RejectsEmptyRange) {
+	EXPECT_THROW(HotspotGenerator(5, 4, 0.2, 0.8), dbbenchmark::utility::InvalidArgumentException);
+	EXPECT_THROW(HotspotGenerator(0, UINT64_MAX, 0.2, 0.8), dbbenchmark::utility::InvalidArgumentException);
+}
+
+std::pair<uint64_t,uint64_t> FormulaTable[] = {
+	std::make_pair(static_cast<uint64_t>(0), static_cast<uint64_t>(2)),
+	std::make_pair(static_cast<uint64_t>(10), static_cast<uint64_t>(50)),
+	std::make_pair(static_cast<uint64_t>(100), static_cast<uint64_t>(200))
+};
+
+INSTANTIATE_TEST_CASE_P(InstantiationName, HotspotGeneratorTest,::testing::ValuesIn(FormulaTable));
+
+} // namespace hotspotgeneratortest
+} // namespace test
+
+#endif // _DBBENCHMARK_HOTSPOTGENERATORTEST_H_
@@ -5,6 +5,7 @@
 
 #include <gtest/gtest.h>
 #include "Core/Generators/ScrambledZipfianGenerator.h"
+#include "Core/Utility/VectorKernels.h"
 
 using namespace dbbenchmark::generators;
 
@@ -46,6 +47,43 @@ TEST_F(ScrambledZipfianGeneratorTest, CreatewithNumberofItems) {
 	EXPECT_TRUE(IsBetweenInclusive(value, 0, 123));
 }
 
+TEST_P(ScrambledZipfianGeneratorTest, NextBatch) {
+	ScrambledZipfianGenerator generator(std::get<0>(GetParam()), std::get<1>(GetParam()));
+	uint64_t values[150];
+	generator.NextBatch(values, 150);
+	for(int i = 0; i < 150; i++)
+		EXPECT_TRUE(IsBetweenInclusive(values[i], std::get<0>(GetParam()), std::get<1>(GetParam())));
+}
+
+TEST_F(ScrambledZipfianGeneratorTest, FNVHashBatchMatchesScalar) {
+	uint64_t input[13], output[13];
+	for(uint64_t i = 0; i < 13; i++)
+		input[i] = i * 0x9E3779B97F4A7C15ULL;
+	dbbenchmark::utility::FNVHash64Batch(input, output, 13);
+	for(int i = 0; i < 13; i++)
+		EXPECT_EQ(dbbenchmark::utility::FNVHash64(input[i]), output[i]);
+}
+
+TEST_F(ScrambledZipfianGeneratorTest, MixHashBatchMatchesScalar) {
+	uint64_t input[13], output[13];
+	for(uint64_t i = 0; i < 13; i++)
+		input[i] = i * 0x9E3779B97F4A7C15ULL;
+	dbbenchmark::utility::MixHash64Batch(input, output, 13);
+	for(int i = 0; i < 13; i++)
+		EXPECT_EQ(dbbenchmark::utility::MixHash64(input[i]), output[i]);
+	EXPECT_NE(dbbenchmark::utility::MixHash64(1), dbbenchmark::utility::MixHash64(2));
+}
+
+TEST_P(ScrambledZipfianGeneratorTest, MixHashNextBatch) {
+	ScrambledZipfianGenerator generator(std::get<0>(GetParam()), std::get<1>(GetParam()),
+		ZipfianGenerator::kZipfianConst, dbbenchmark::utility::MIX_HASH);
+	uint64_t values[150];
+	generator.NextBatch(values, 150);
+	for(int i = 0; i < 150; i++)
+		EXPECT_TRUE(IsBetweenInclusive(values[i], std::get<0>(GetParam()), std::get<1>(GetParam())));
+	EXPECT_TRUE(IsBetweenInclusive(generator.Next(), std::get<0>(GetParam()), std::get<1>(GetParam())));
+}
+
 std::pair<uint64_t,uint64_t> FormulaTable[] = {
 	std::make_pair(static_cast<uint64_t>(0), static_cast<uint64_t>(2)),
 	std::make_pair(static_cast<uint64_t>(10), static_cast<uint64_t>(50)),
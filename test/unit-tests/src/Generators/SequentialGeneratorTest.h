@@ -0,0 +1,56 @@
+// SequentialGeneratorTest.h
+
+#ifndef _DBBENCHMARK_SEQUENTIALGENERATORTEST_H_
+#define _DBBENCHMARK_SEQUENTIALGENERATORTEST_H_
+
+#include <gtest/gtest.h>
+#include "Core/Generators/SequentialGenerator.h"
+
+using namespace dbbenchmark::generators;
+
+namespace test {
+namespace sequentialgeneratortest {
+
+class SequentialGeneratorTest  : public ::testing::TestWithParam<uint64_t> {
+	virtual void SetUp() { return; }
+	virtual void TearDown() { return; }
+};
+
+TEST_P(SequentialGeneratorTest, NextValue) {
+	SequentialGenerator generator(GetParam(), GetParam() + 2);
+	EXPECT_EQ(GetParam(), generator.Next());
+	EXPECT_EQ(GetParam() + 1, generator.Next());
+	EXPECT_EQ(GetParam() + 2, generator.Next());
+	EXPECT_EQ(GetParam(), generator.Next());
+}
+
+TEST_P(SequentialGeneratorTest, LastValue) {
+	SequentialGenerator generator(GetParam(), GetParam() + 2);
+	for(int i = 0; i < 2; i++)
+		generator.Next();
+	ASSERT_EQ(GetParam() + 1, generator.Last());
+}
+
+TEST_P(SequentialGeneratorTest, NextBatch) {
+	SequentialGenerator generator(GetParam(), GetParam() + 2);
+	generator.Next();
+	uint64_t values[5];
+	generator.NextBatch(values, 5);
+	uint64_t expected[5] = {GetParam() + 1, GetParam() + 2, GetParam(), GetParam() + 1, GetParam() + 2};
+	for(int i = 0; i < 5; i++)
+		EXPECT_EQ(expected[i], values[i]);
+	EXPECT_EQ(GetParam() + 2, generator.Last());
+}
+
+TEST_F(SequentialGeneratorTest, RejectsEmptyRange) {
+	EXPECT_THROW(SequentialGenerator(5, 4), dbbenchmark::utility::InvalidArgumentException);
+	EXPECT_THROW(SequentialGenerator(0, UINT64_MAX), dbbenchmark::utility::InvalidArgumentException);
+}
+
+INSTANTIATE_TEST_CASE_P(InstantiationName, SequentialGeneratorTest, ::testing::Values(static_cast<uint64_t>(0), static_cast<uint64_t>(2),
+						static_cast<uint64_t>(12345)));
+
+} // namespace sequentialgeneratortest
+} // namespace test
+
+#endif // _DBBENCHMARK_SEQUENTIALGENERATORTEST_H_
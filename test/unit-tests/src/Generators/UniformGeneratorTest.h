@@ -40,6 +40,19 @@ TEST_P(UniformGeneratorTest, LastValue) {
 	EXPECT_TRUE(IsBetweenInclusive(value, std::get<0>(GetParam()), std::get<1>(GetParam())));
 }
 
+TEST_P(UniformGeneratorTest, NextBatch) {
+	UniformGenerator generator(std::get<0>(GetParam()), std::get<1>(GetParam()));
+	uint64_t values[37];
+	generator.NextBatch(values, 37);
+	for(int i = 0; i < 37; i++)
+		EXPECT_TRUE(IsBetweenInclusive(values[i], std::get<0>(GetParam()), std::get<1>(GetParam())));
+	EXPECT_EQ(values[36], generator.Last());
+}
+
+TEST(UniformGeneratorRangeTest, RejectsEmptyRange) {
+	EXPECT_THROW(UniformGenerator(5, 4), dbbenchmark::utility::InvalidArgumentException);
+}
+
 std::pair<uint64_t,uint64_t> FormulaTable[] = {
 	std::make_pair(static_cast<uint64_t>(0), static_cast<uint64_t>(2)),
 	std::make_pair(static_cast<uint64_t>(10), static_cast<uint64_t>(50)),
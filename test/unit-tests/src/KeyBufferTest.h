@@ -0,0 +1,65 @@
+// KeyBufferTest.h
+
+#ifndef _DBBENCHMARK_KEYBUFFERTEST_H_
+#define _DBBENCHMARK_KEYBUFFERTEST_H_
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include "Core/Utility/KeyBuffer.h"
+
+using namespace dbbenchmark::utility;
+
+namespace test {
+namespace keybuffertest {
+
+class KeyBufferTest  : public ::testing::Test {
+	virtual void SetUp() { return; }
+	virtual void TearDown() { return; }
+};
+
+TEST_F(KeyBufferTest, MatchesToString) {
+	KeyBuffer buffer;
+	std::mt19937_64 generator(5);
+	uint64_t power = 1;
+	for(int i = 0; i < 20; i++, power *= 10) {
+		EXPECT_EQ("user" + std::to_string(power), buffer.Format("user", power, 1));
+		EXPECT_EQ("user" + std::to_string(power - 1), buffer.Format("user", power - 1, 1));
+	}
+	for(int i = 0; i < 10000; i++) {
+		uint64_t value = generator() >> (i % 64);
+		EXPECT_EQ("user" + std::to_string(value), buffer.Format("user", value, 1));
+	}
+	EXPECT_EQ("user18446744073709551615", buffer.Format("user", UINT64_MAX, 1));
+}
+
+TEST_F(KeyBufferTest, ZeroPadding) {
+	KeyBuffer buffer;
+	EXPECT_EQ("user00000005", buffer.Format("user", 5, 8));
+	EXPECT_EQ("user123456789", buffer.Format("user", 123456789, 8));
+	EXPECT_EQ("k0000", buffer.Format("k", 0, 4));
+	EXPECT_EQ("42", buffer.Format("", 42, 2));
+}
+
+TEST_F(KeyBufferTest, NulTerminated) {
+	KeyBuffer buffer;
+	buffer.Format("user", 1234567890, 1);
+	std::string_view key = buffer.Format("user", 7, 1);
+	EXPECT_EQ('\0', key.data()[key.size()]);
+	EXPECT_STREQ("user7", buffer.c_str());
+}
+
+TEST_F(KeyBufferTest, Fits) {
+	EXPECT_TRUE(KeyBuffer::Fits(4, 1));
+	EXPECT_TRUE(KeyBuffer::Fits(KeyBuffer::kCapacity - KeyBuffer::kMaxDigits - 1, 1));
+	EXPECT_FALSE(KeyBuffer::Fits(KeyBuffer::kCapacity - KeyBuffer::kMaxDigits, 1));
+	EXPECT_FALSE(KeyBuffer::Fits(4, KeyBuffer::kCapacity));
+}
+
+} // namespace keybuffertest
+} // namespace test
+
+#endif // _DBBENCHMARK_KEYBUFFERTEST_H_
@@ -0,0 +1,103 @@
+// OperationStreamTest.h
+
+#ifndef _DBBENCHMARK_OPERATIONSTREAMTEST_H_
+#define _DBBENCHMARK_OPERATIONSTREAMTEST_H_
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "Core/Workloads/OperationStream.h"
+
+using namespace dbbenchmark::workloads;
+
+namespace test {
+namespace operationstreamtest {
+
+class OperationStreamTest  : public ::testing::Test {
+public:
+	const std::string fileName = "operation_stream_test.bin";
+
+	void WriteStream(uint64_t count) {
+		OperationStreamWriter writer(fileName);
+		for(uint64_t i = 0; i < count; i++) {
+			OperationRecord record = {};
+			record.keyNum = i * 3;
+			record.lengthSeed = static_cast<uint32_t>(i % 100);
+			record.operation = static_cast<uint8_t>(i % 5);
+			writer.write(record);
+		}
+	}
+	virtual void TearDown() { std::remove(fileName.c_str()); }
+};
+
+TEST_F(OperationStreamTest, RoundTrip) {
+	WriteStream(1000);
+	OperationStreamReader reader(fileName);
+	ASSERT_EQ(1000u, reader.size());
+	for(uint64_t i = 0; i < reader.size(); i++) {
+		EXPECT_EQ(i * 3, reader.records()[i].keyNum);
+		EXPECT_EQ(i % 100, reader.records()[i].lengthSeed);
+		EXPECT_EQ(i % 5, reader.records()[i].operation);
+	}
+}
+
+TEST_F(OperationStreamTest, PartitionsCoverStream) {
+	WriteStream(1001);
+	OperationStreamReader reader(fileName);
+	std::vector<int> seen(reader.size(), 0);
+	for(std::size_t i = 0; i < 4; i++) {
+		std::size_t count = 0;
+		const OperationRecord *first = reader.partition(i, 4, count);
+		EXPECT_EQ(reader.records() + i, first);
+		EXPECT_EQ(i == 0 ? 251u : 250u, count);
+		// Round-robin: each partition takes every fourth record, in order.
+		for(std::size_t j = 0; j < count; j++) {
+			++seen[first + j * 4 - reader.records()];
+		}
+	}
+	for(int times : seen) {
+		ASSERT_EQ(1, times);
+	}
+	std::size_t count = 1;
+	reader.partition(2, 2000, count);
+	EXPECT_EQ(1u, count);
+	reader.partition(1500, 2000, count);
+	EXPECT_EQ(0u, count);
+}
+
+TEST_F(OperationStreamTest, KeepsValueSettings) {
+	ValueSettings values;
+	values.seed = 0x123456789abcdefULL;
+	values.fieldLengths = {{1, 2, 3}, {40, 50, 60}, {7, 8, 9}};
+	{
+		OperationStreamWriter writer(fileName, values);
+		OperationRecord record = {};
+		record.keyNum = 11;
+		writer.write(record);
+	}
+	OperationStreamReader reader(fileName);
+	EXPECT_EQ(values.seed, reader.values().seed);
+	EXPECT_EQ(values.fieldLengths, reader.values().fieldLengths);
+	ASSERT_EQ(1u, reader.size());
+	EXPECT_EQ(11u, reader.records()[0].keyNum);
+	// Records stay aligned after an odd number of length samples.
+	EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(reader.records()) % 8);
+	values.fieldLengths[1].pop_back();
+	EXPECT_THROW(OperationStreamWriter writer(fileName, values), dbbenchmark::utility::InvalidArgumentException);
+}
+
+TEST_F(OperationStreamTest, BadFile) {
+	{
+		std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+		out << "not an operation stream";
+	}
+	EXPECT_THROW(OperationStreamReader reader(fileName), dbbenchmark::utility::DataException);
+	EXPECT_THROW(OperationStreamReader reader("does_not_exist.bin"), dbbenchmark::utility::FileException);
+}
+
+} // namespace operationstreamtest
+} // namespace test
+
+#endif // _DBBENCHMARK_OPERATIONSTREAMTEST_H_
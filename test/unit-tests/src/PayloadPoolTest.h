@@ -0,0 +1,121 @@
+// PayloadPoolTest.h
+
+#ifndef _DBBENCHMARK_PAYLOADPOOLTEST_H_
+#define _DBBENCHMARK_PAYLOADPOOLTEST_H_
+
+#include <gtest/gtest.h>
+#include <cctype>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+
+#include "Core/Utility/PayloadPool.h"
+
+using namespace dbbenchmark::utility;
+using dbbenchmark::PayloadType;
+
+namespace test {
+namespace payloadpooltest {
+
+class PayloadPoolTest  : public ::testing::Test {
+	virtual void SetUp() { return; }
+	virtual void TearDown() { return; }
+};
+
+TEST_F(PayloadPoolTest, UuidsAreVersion4) {
+	PayloadPool pool(dbbenchmark::UUID_PAYLOAD, 11);
+	std::set<std::string_view> distinct;
+	for(std::size_t i = 0; i < PayloadPool::kEntries; i++) {
+		std::string_view uuid = pool[i];
+		ASSERT_EQ(36u, uuid.size());
+		for(std::size_t j = 0; j < uuid.size(); j++) {
+			if(j == 8 || j == 13 || j == 18 || j == 23)
+				ASSERT_EQ('-', uuid[j]);
+			else
+				ASSERT_TRUE(std::isxdigit(static_cast<unsigned char>(uuid[j])));
+		}
+		ASSERT_EQ('4', uuid[14]);
+		ASSERT_NE(std::string_view::npos, std::string_view("89ab").find(uuid[19]));
+		distinct.insert(uuid);
+	}
+	EXPECT_EQ(PayloadPool::kEntries, distinct.size());
+}
+
+TEST_F(PayloadPoolTest, IntegersSpanMagnitudes) {
+	PayloadPool pool(dbbenchmark::INTEGER_PAYLOAD, 12);
+	std::set<std::size_t> lengths;
+	bool negative = false;
+	for(std::size_t i = 0; i < PayloadPool::kEntries; i++) {
+		std::string text(pool[i]);
+		ASSERT_EQ(std::to_string(std::stoll(text)), text);
+		negative |= (text[0] == '-');
+		lengths.insert(text.size());
+	}
+	EXPECT_TRUE(negative);
+	EXPECT_GT(lengths.size(), 15u);
+}
+
+TEST_F(PayloadPoolTest, CountersCountUp) {
+	PayloadPool pool(dbbenchmark::COUNTER_PAYLOAD, 15);
+	int64_t previous = std::stoll(std::string(pool.Next()));
+	ASSERT_GE(previous, 0);
+	for(std::size_t i = 2; i < PayloadPool::kEntries; i++) {
+		int64_t value = std::stoll(std::string(pool.Next()));
+		ASSERT_EQ(previous + 1, value);
+		previous = value;
+	}
+}
+
+TEST_F(PayloadPoolTest, JsonDocumentsAreNested) {
+	PayloadPool pool(dbbenchmark::JSON_PAYLOAD, 13);
+	for(std::size_t i = 0; i < PayloadPool::kEntries; i++) {
+		std::string_view document = pool[i];
+		ASSERT_EQ(0u, document.find("{\"id\":"));
+		ASSERT_EQ('}', document.back());
+		ASSERT_NE(std::string_view::npos, document.find("\"address\":{"));
+		ASSERT_NE(std::string_view::npos, document.find("\"tags\":["));
+		int depth = 0, max_depth = 0;
+		for(char c : document) {
+			if(c == '{') max_depth = std::max(max_depth, ++depth);
+			if(c == '}') depth--;
+			ASSERT_GE(depth, 0);
+		}
+		ASSERT_EQ(0, depth);
+		ASSERT_EQ(2, max_depth);
+	}
+}
+
+TEST_F(PayloadPoolTest, NextWalksAllEntries) {
+	PayloadPool pool(dbbenchmark::UUID_PAYLOAD, 14);
+	std::set<const char *> starts;
+	for(std::size_t i = 0; i < PayloadPool::kEntries; i++)
+		starts.insert(pool.Next().data());
+	EXPECT_EQ(PayloadPool::kEntries, starts.size());
+}
+
+TEST_F(PayloadPoolTest, ThreadLocalPerType) {
+	EXPECT_EQ(dbbenchmark::JSON_PAYLOAD, PayloadPool::ThreadLocal(dbbenchmark::JSON_PAYLOAD).type());
+	EXPECT_EQ(dbbenchmark::UUID_PAYLOAD, PayloadPool::ThreadLocal(dbbenchmark::UUID_PAYLOAD).type());
+	EXPECT_EQ(&PayloadPool::ThreadLocal(dbbenchmark::JSON_PAYLOAD),
+			&PayloadPool::ThreadLocal(dbbenchmark::JSON_PAYLOAD));
+}
+
+TEST_F(PayloadPoolTest, RejectsUnstructuredTypes) {
+	EXPECT_THROW(PayloadPool(dbbenchmark::ASCII_PAYLOAD, 1), InvalidArgumentException);
+	EXPECT_THROW(PayloadPool(dbbenchmark::BINARY_PAYLOAD, 1), InvalidArgumentException);
+}
+
+TEST_F(PayloadPoolTest, SameSeedSameValueAtPosition) {
+	PayloadPool pool(dbbenchmark::JSON_PAYLOAD, 33);
+	EXPECT_EQ(pool.At(77), PayloadPool::ThreadLocal(dbbenchmark::JSON_PAYLOAD, 33).At(77));
+	EXPECT_EQ(33u, PayloadPool::ThreadLocal(dbbenchmark::JSON_PAYLOAD, 33).seed());
+	// Counters count up from one position to the next.
+	PayloadPool counters(dbbenchmark::COUNTER_PAYLOAD, 33);
+	EXPECT_EQ(std::stoull(std::string(counters.At(5))) + 1, std::stoull(std::string(counters.At(6))));
+}
+
+} // namespace payloadpooltest
+} // namespace test
+
+#endif // _DBBENCHMARK_PAYLOADPOOLTEST_H_
@@ -0,0 +1,123 @@
+// RecordLayoutTest.h
+
+#ifndef _DBBENCHMARK_RECORDLAYOUTTEST_H_
+#define _DBBENCHMARK_RECORDLAYOUTTEST_H_
+
+#include <gtest/gtest.h>
+
+#include "Redis/RecordLayout.h"
+
+using namespace dbbenchmark::redisdb;
+
+namespace test {
+namespace recordlayouttest {
+
+class RecordLayoutTest  : public ::testing::Test {
+public:
+	RecordLayoutTest() : binary("a\0\"\\\x01\x7f\xff\n", 8), large(300, 'x') {
+		values.push_back({"field0", "hello"});
+		values.push_back({"field1", binary});
+		values.push_back({"field2", large});
+		values.push_back({"field3", ""});
+	}
+	std::string binary;
+	std::string large;
+	std::vector<dbbenchmark::FieldValue> values;
+	std::string encoded;
+	dbbenchmark::ReadResult result;
+};
+
+TEST_F(RecordLayoutTest, ParseLayout) {
+	Layout layout = Layout::HASH;
+	ASSERT_TRUE(ParseLayout("packed", layout));
+	EXPECT_TRUE(layout == Layout::PACKED);
+	ASSERT_TRUE(ParseLayout("json", layout));
+	EXPECT_TRUE(layout == Layout::JSON);
+	ASSERT_TRUE(ParseLayout("hash", layout));
+	EXPECT_TRUE(layout == Layout::HASH);
+	EXPECT_FALSE(ParseLayout("Packed", layout));
+}
+
+TEST_F(RecordLayoutTest, PackedRoundTrip) {
+	PackedRecord::Encode(values, encoded);
+	// A varint per name and value, two bytes for the 300 byte value.
+	EXPECT_EQ(4 * 6 + 5 + 8 + 300 + 9, encoded.size());
+	ASSERT_TRUE(PackedRecord::Decode(encoded, dbbenchmark::FieldList(), result));
+	ASSERT_EQ(4u, result.size());
+	EXPECT_EQ("field0", result[0].first);
+	EXPECT_EQ("hello", result[0].second);
+	EXPECT_EQ(binary, result[1].second);
+	EXPECT_EQ(large, result[2].second);
+	EXPECT_EQ("", result[3].second);
+}
+
+TEST_F(RecordLayoutTest, JsonRoundTrip) {
+	JsonRecord::Encode(dbbenchmark::RecordView(values.data(), 2), encoded);
+	EXPECT_EQ(std::string("{\"field0\":\"hello\",\"field1\":\"a\\u0000\\\"\\\\\\u0001\\u007f\xff\\n\"}"), encoded);
+	JsonRecord::Encode(values, encoded);
+	ASSERT_TRUE(JsonRecord::Decode(encoded, dbbenchmark::FieldList(), result));
+	ASSERT_EQ(4u, result.size());
+	EXPECT_EQ("field0", result[0].first);
+	EXPECT_EQ("hello", result[0].second);
+	EXPECT_EQ(binary, result[1].second);
+	EXPECT_EQ(large, result[2].second);
+	EXPECT_EQ("", result[3].second);
+}
+
+TEST_F(RecordLayoutTest, DecodeSelectedFields) {
+	std::vector<std::string> names = {"field2", "field1"};
+	PackedRecord::Encode(values, encoded);
+	ASSERT_TRUE(PackedRecord::Decode(encoded, names, result));
+	ASSERT_EQ(2u, result.size());
+	EXPECT_EQ("field1", result[0].first);
+	EXPECT_EQ("field2", result[1].first);
+	result.clear();
+	JsonRecord::Encode(values, encoded);
+	ASSERT_TRUE(JsonRecord::Decode(encoded, names, result));
+	ASSERT_EQ(2u, result.size());
+	EXPECT_EQ(binary, result[0].second);
+	EXPECT_EQ(large, result[1].second);
+}
+
+TEST_F(RecordLayoutTest, JsonAsCjsonEncodesIt) {
+	ASSERT_TRUE(JsonRecord::Decode(" { \"b\" : \"x\\/y\\t\\u00e9\\ud83d\\ude00\" , \"a\":\"\\u007f\" } ",
+	                               dbbenchmark::FieldList(), result));
+	ASSERT_EQ(2u, result.size());
+	EXPECT_EQ("b", result[0].first);
+	EXPECT_EQ("x/y\t\xc3\xa9\xf0\x9f\x98\x80", result[0].second);
+	EXPECT_EQ("\x7f", result[1].second);
+	result.clear();
+	EXPECT_TRUE(JsonRecord::Decode("{}", dbbenchmark::FieldList(), result));
+	EXPECT_TRUE(result.empty());
+}
+
+TEST_F(RecordLayoutTest, RejectsMalformedRecords) {
+	PackedRecord::Encode(values, encoded);
+	EXPECT_FALSE(PackedRecord::Decode(std::string_view(encoded).substr(0, encoded.size() - 1),
+	                                  dbbenchmark::FieldList(), result));
+	EXPECT_FALSE(PackedRecord::Decode("\x80\x80", dbbenchmark::FieldList(), result));
+	EXPECT_FALSE(PackedRecord::Decode(std::string_view("\x06" "field0", 7), dbbenchmark::FieldList(), result));
+	EXPECT_FALSE(JsonRecord::Decode("{\"a\":1}", dbbenchmark::FieldList(), result));
+	EXPECT_FALSE(JsonRecord::Decode("{\"a\":\"b\"", dbbenchmark::FieldList(), result));
+	EXPECT_FALSE(JsonRecord::Decode("{\"a\":\"b\\", dbbenchmark::FieldList(), result));
+	EXPECT_FALSE(JsonRecord::Decode("{\"a\":\"\\u00\"}", dbbenchmark::FieldList(), result));
+	EXPECT_FALSE(JsonRecord::Decode("{\"a\":\"b\"} x", dbbenchmark::FieldList(), result));
+}
+
+TEST_F(RecordLayoutTest, TablesDoNotShareKeys) {
+	const std::string usertable = "usertable";
+	const std::string othertable = "othertable";
+	std::string first, second;
+	EXPECT_EQ("usertable:user7", RecordKey(usertable, "user7", first));
+	EXPECT_EQ("othertable:user7", RecordKey(othertable, "user7", second));
+	EXPECT_NE(first, second);
+	// Each table has its own index too.
+	EXPECT_NE(RecordKey(usertable, "_indices", first), RecordKey(othertable, "_indices", second));
+	// The buffer is reused: a shorter key leaves nothing of the longer one behind.
+	EXPECT_EQ("usertable:u", RecordKey(usertable, "u", second));
+}
+
+} // namespace recordlayouttest
+} // namespace test
+
+#endif // _DBBENCHMARK_RECORDLAYOUTTEST_H_
@@ -0,0 +1,208 @@
+// RespPipelineTest.h
+
+#ifndef _DBBENCHMARK_RESPPIPELINETEST_H_
+#define _DBBENCHMARK_RESPPIPELINETEST_H_
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "Redis/RespPipeline.h"
+
+using namespace dbbenchmark::redisdb;
+
+namespace test {
+namespace resppipelinetest {
+
+///
+/// The socket of a CannedClient: reads hand out input at most chunk bytes at
+/// a time, so a reply can be split anywhere, and writes are kept.
+///
+struct CannedStream {
+	std::string input;
+	std::size_t pos = 0;
+	std::size_t chunk = 16384;
+	std::string written;
+
+	int read(void *buffer, std::size_t size, bool) {
+		if (pos == input.size()) {
+			return -1;
+		}
+		std::size_t count = std::min(std::min(size, chunk), input.size() - pos);
+		std::memcpy(buffer, input.data() + pos, count);
+		pos += count;
+		return static_cast<int>(count);
+	}
+	int write(const void *data, std::size_t size) {
+		written.append(static_cast<const char *>(data), size);
+		return static_cast<int>(size);
+	}
+};
+
+struct CannedClient {
+	CannedStream stream;
+	bool closed = false;
+
+	CannedStream *get_stream() { return &stream; }
+	void close() { closed = true; }
+};
+
+class RespPipelineTest : public ::testing::Test {
+public:
+	RespPipelineTest() : pipeline(&client) { }
+	~RespPipelineTest() override { }
+	/// Queue count PINGs, send them and make input their replies, chunk bytes per read.
+	void Reply(std::size_t count, const std::string &input, std::size_t chunk) {
+		for (std::size_t i = 0; i < count; ++i) {
+			pipeline.command(1);
+			pipeline.argument("PING");
+		}
+		ASSERT_TRUE(pipeline.send());
+		client.stream.input = input;
+		client.stream.pos = 0;
+		client.stream.chunk = chunk;
+	}
+	CannedClient client;
+	BasicRespPipeline<CannedClient> pipeline;
+	RespReply reply;
+};
+
+TEST_F(RespPipelineTest, EncodesCommands) {
+	pipeline.command(3);
+	pipeline.argument("SET");
+	pipeline.argument("key");
+	pipeline.argument(std::string("a\r\n\0b", 5));
+	ASSERT_EQ(1u, pipeline.queued());
+	ASSERT_TRUE(pipeline.send());
+	EXPECT_EQ(std::string("*3\r\n$3\r\nSET\r\n$3\r\nkey\r\n$5\r\na\r\n\0b\r\n", 33), client.stream.written);
+}
+
+TEST_F(RespPipelineTest, NestedArrays) {
+	for (std::size_t chunk : {16384, 1}) {
+		Reply(2, "*2\r\n*2\r\n:1\r\n$3\r\nabc\r\n*0\r\n+OK\r\n", chunk);
+		ASSERT_TRUE(pipeline.read(reply));
+		ASSERT_EQ('*', reply.type);
+		ASSERT_EQ(2, reply.integer);
+		ASSERT_TRUE(pipeline.element(reply));
+		ASSERT_EQ('*', reply.type);
+		ASSERT_EQ(2, reply.integer);
+		ASSERT_TRUE(pipeline.element(reply));
+		ASSERT_EQ(':', reply.type);
+		ASSERT_EQ(1, reply.integer);
+		ASSERT_TRUE(pipeline.element(reply));
+		ASSERT_EQ('$', reply.type);
+		ASSERT_EQ("abc", reply.text);
+		ASSERT_TRUE(pipeline.element(reply));
+		ASSERT_EQ('*', reply.type);
+		ASSERT_EQ(0, reply.integer);
+		ASSERT_TRUE(pipeline.read(reply));
+		ASSERT_EQ('+', reply.type);
+		ASSERT_EQ("OK", reply.text);
+		ASSERT_EQ(0u, pipeline.queued());
+	}
+}
+
+TEST_F(RespPipelineTest, NullBulkStrings) {
+	for (std::size_t chunk : {16384, 1}) {
+		Reply(3, "$-1\r\n*-1\r\n*3\r\n$-1\r\n$0\r\n\r\n$2\r\nab\r\n", chunk);
+		ASSERT_TRUE(pipeline.read(reply));
+		EXPECT_TRUE(reply.isNil());
+		ASSERT_TRUE(pipeline.read(reply));
+		EXPECT_TRUE(reply.isNil());
+		ASSERT_TRUE(pipeline.read(reply));
+		ASSERT_EQ(3, reply.integer);
+		std::string value = "stale";
+		bool nil = false;
+		ASSERT_TRUE(pipeline.bulk(value, nil));
+		EXPECT_TRUE(nil);
+		EXPECT_EQ("", value);
+		ASSERT_TRUE(pipeline.bulk(value, nil));
+		EXPECT_FALSE(nil);
+		EXPECT_EQ("", value);
+		ASSERT_TRUE(pipeline.bulk(value, nil));
+		EXPECT_FALSE(nil);
+		EXPECT_EQ("ab", value);
+	}
+}
+
+TEST_F(RespPipelineTest, ErrorReplies) {
+	for (std::size_t chunk : {16384, 1}) {
+		Reply(3, "-ERR wrong type\r\n-MOVED 3999 127.0.0.1:6381\r\n:5\r\n", chunk);
+		ASSERT_TRUE(pipeline.read(reply));
+		EXPECT_TRUE(reply.isError());
+		EXPECT_EQ("ERR wrong type", reply.text);
+		EXPECT_TRUE(pipeline.skip(reply));
+		ASSERT_TRUE(pipeline.read(reply));
+		EXPECT_TRUE(reply.isError());
+		EXPECT_EQ("MOVED 3999 127.0.0.1:6381", reply.text);
+		ASSERT_TRUE(pipeline.read(reply));
+		EXPECT_EQ(':', reply.type);
+		EXPECT_EQ(5, reply.integer);
+	}
+}
+
+TEST_F(RespPipelineTest, RepliesSplitAcrossReads) {
+	// Longer than one fill of the input buffer, so bulk() reads the rest from the socket.
+	const std::string large(40000, 'x');
+	for (std::size_t chunk : {16384, 1000, 1}) {
+		Reply(3, "*2\r\n$40000\r\n" + large + "\r\n$5\r\nhello\r\n$5\r\nworld\r\n:7\r\n", chunk);
+		ASSERT_TRUE(pipeline.read(reply));
+		ASSERT_EQ(2, reply.integer);
+		std::string value;
+		bool nil = false;
+		ASSERT_TRUE(pipeline.bulk(value, nil));
+		EXPECT_EQ(large, value);
+		ASSERT_TRUE(pipeline.bulk(value, nil));
+		EXPECT_EQ("hello", value);
+		ASSERT_TRUE(pipeline.read(reply));
+		EXPECT_EQ("world", reply.text);
+		ASSERT_TRUE(pipeline.read(reply));
+		EXPECT_EQ(7, reply.integer);
+	}
+}
+
+TEST_F(RespPipelineTest, SkipAfterPartialRead) {
+	for (std::size_t chunk : {16384, 1}) {
+		Reply(3, "*3\r\n$1\r\na\r\n*2\r\n:1\r\n*1\r\n$1\r\nb\r\n$1\r\nc\r\n"
+		         "*2\r\n$1\r\nd\r\n*1\r\n:2\r\n+NEXT\r\n", chunk);
+		// Take the first element, then drop the rest one element at a time.
+		ASSERT_TRUE(pipeline.read(reply));
+		ASSERT_EQ(3, reply.integer);
+		std::string value;
+		bool nil = false;
+		ASSERT_TRUE(pipeline.bulk(value, nil));
+		EXPECT_EQ("a", value);
+		for (int i = 1; i < 3; ++i) {
+			RespReply element;
+			ASSERT_TRUE(pipeline.element(element));
+			ASSERT_TRUE(pipeline.skip(element));
+		}
+		// Or drop a whole reply right after its header.
+		ASSERT_TRUE(pipeline.read(reply));
+		ASSERT_TRUE(pipeline.skip(reply));
+		ASSERT_TRUE(pipeline.read(reply));
+		EXPECT_EQ("NEXT", reply.text);
+	}
+}
+
+TEST_F(RespPipelineTest, FailsOnTruncatedOrMalformedReplies) {
+	// Each failure is followed by a reset(), as RedisDB does, which drops the unread input.
+	for (const char *input : {"$5\r\nhel", ":12a\r\n", "?\r\n", "+OK"}) {
+		Reply(2, input, 1);
+		EXPECT_FALSE(pipeline.read(reply)) << input;
+		client.closed = false;
+		pipeline.reset();
+		EXPECT_TRUE(client.closed);
+		EXPECT_EQ(0u, pipeline.queued());
+	}
+	Reply(1, "+OK\r\n", 1);
+	ASSERT_TRUE(pipeline.read(reply));
+	EXPECT_EQ("OK", reply.text);
+}
+
+} // namespace resppipelinetest
+} // namespace test
+
+#endif // _DBBENCHMARK_RESPPIPELINETEST_H_
@@ -0,0 +1,64 @@
+// ReusedVectorTest.h
+
+#ifndef _DBBENCHMARK_REUSEDVECTORTEST_H_
+#define _DBBENCHMARK_REUSEDVECTORTEST_H_
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "Core/Record.h"
+
+namespace test {
+namespace reusedvectortest {
+
+class ReusedVectorTest : public ::testing::Test {
+public:
+	ReusedVectorTest() : large(100, 'x') { }
+	~ReusedVectorTest() override { }
+	std::string large;
+};
+
+TEST_F(ReusedVectorTest, ClearKeepsStorage) {
+	dbbenchmark::ReadResult result;
+	result.emplace_back().second.assign(large);
+	const char *storage = result[0].second.data();
+	result.clear();
+	EXPECT_TRUE(result.empty());
+	std::pair<std::string, std::string> &field = result.emplace_back();
+	EXPECT_TRUE(field.first.empty());
+	EXPECT_TRUE(field.second.empty());
+	field.second.assign(large);
+	EXPECT_EQ(storage, result[0].second.data());
+	EXPECT_EQ(1u, result.size());
+}
+
+TEST_F(ReusedVectorTest, ResizeEmptiesReusedElements) {
+	dbbenchmark::ScanResult result;
+	result.resize(3);
+	result[2].emplace_back().first.assign("field0");
+	result.resize(1);
+	EXPECT_EQ(1u, result.size());
+	result.resize(3);
+	EXPECT_TRUE(result[2].empty());
+	int rows = 0;
+	for (const dbbenchmark::ReadResult &row : result) {
+		EXPECT_TRUE(row.empty());
+		++rows;
+	}
+	EXPECT_EQ(3, rows);
+}
+
+TEST_F(ReusedVectorTest, PopBack) {
+	dbbenchmark::ReadResult result;
+	result.emplace_back().first.assign("field0");
+	result.emplace_back().first.assign("field1");
+	result.pop_back();
+	ASSERT_EQ(1u, result.size());
+	EXPECT_EQ("field0", result.back().first);
+}
+
+} // namespace reusedvectortest
+} // namespace test
+
+#endif // _DBBENCHMARK_REUSEDVECTORTEST_H_
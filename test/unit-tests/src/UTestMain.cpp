@@ -2,10 +2,28 @@
 
 #include "Generators/ConstGeneratorTest.h"
 #include "Generators/CounterGeneratorTest.h"
+#include "Generators/AcknowledgedCounterGeneratorTest.h"
 #include "Generators/DiscreteGeneratorTest.h"
 #include "Generators/ScrambledZipfianGeneratorTest.h"
 #include "Generators/ScrambledZipfianGeneratorTest.h"
 #include "Generators/UniformGeneratorTest.h"
+#include "Generators/HotspotGeneratorTest.h"
+#include "Generators/SequentialGeneratorTest.h"
+#include "Generators/ExponentialGeneratorTest.h"
+#include "Generators/EmpiricalGeneratorTest.h"
+#include "Generators/DriftingGeneratorTest.h"
+#include "AllocationCounterTest.h"
+#include "KeyBufferTest.h"
+#include "ReusedVectorTest.h"
+#include "ValuePoolTest.h"
+#include "PayloadPoolTest.h"
+#include "DataIntegrityTest.h"
+#include "OperationStreamTest.h"
+#include "ClusterSlotsTest.h"
+#include "RecordLayoutTest.h"
+#include "RespPipelineTest.h"
+#include "WorkloadSettingsTest.h"
+#include "ClientTest.h"
 #include "CoreWorkloadTest.h"
 
 using namespace testing;
@@ -0,0 +1,154 @@
+// WorkloadTestHelper.h
+
+#ifndef _DBBENCHMARK_WORKLOADTESTHELPER_H_
+#define _DBBENCHMARK_WORKLOADTESTHELPER_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Core/DB.h"
+#include "Core/Utility/ProgramConfigurations/MapConfiguration.h"
+#include "Core/Utility/ProgramConfigurations/LayeredConfiguration.h"
+#include "Core/Workloads/CoreWorkload.h"
+
+namespace test {
+namespace workloadtesthelper {
+
+///
+/// Workload settings in front of every other configuration while the object
+/// lives, so a test can Init() a CoreWorkload without a settings file.
+///
+class ScopedSettings {
+public:
+	ScopedSettings() : settings(new dbbenchmark::utility::programconfigurations::MapConfiguration()) {
+		dbbenchmark::utility::programconfigurations::LayeredConfiguration::Instance().addFront(settings);
+	}
+	~ScopedSettings() {
+		dbbenchmark::utility::programconfigurations::LayeredConfiguration::Instance().removeConfiguration(settings);
+	}
+	/// Set the workload property name, e.g. "recordcount".
+	void set(const std::string &name, const std::string &value) {
+		settings->setString(dbbenchmark::workloads::CoreWorkload::WORKLOAD_KEY + name, value);
+	}
+
+private:
+	std::shared_ptr<dbbenchmark::utility::programconfigurations::MapConfiguration> settings;
+};
+
+///
+/// One call a RecordingDB received, with copies of its arguments.
+///
+struct RecordedCall {
+	dbbenchmark::DBOperation::Type type;
+	std::string table;
+	std::string key;
+	std::vector<std::pair<std::string, std::string>> values;
+};
+
+///
+/// A DB that answers every read with resultFields fields holding value,
+/// every scan with the records asked for, and, while recording is set, keeps
+/// a copy of each call. Calls return status, or ERROR for a key in failingKeys
+/// or a call of a type in failingTypes. depth is the pipelineDepth() it reports.
+/// batchInsert() notes the table and size of each batch, then runs the default
+/// loop of DB, so its records are recorded as inserts.
+///
+class RecordingDB : public dbbenchmark::DB {
+public:
+	RecordingDB() : recording(true), resultFields(2), value(100, 'v'), status(dbbenchmark::utility::Status::OK),
+	                depth(1) { }
+
+	void init() override { }
+	void cleanup() override { }
+	dbbenchmark::utility::Status read(const std::string &table, std::string_view key,
+	                         dbbenchmark::FieldList fields, dbbenchmark::ReadResult &result) override {
+		Record(dbbenchmark::DBOperation::READ, table, key, dbbenchmark::RecordView());
+		Fill(fields, result);
+		return StatusOf(dbbenchmark::DBOperation::READ, key);
+	}
+	dbbenchmark::utility::Status scan(const std::string &table, std::string_view startkey, int recordcount,
+	                         dbbenchmark::FieldList fields, dbbenchmark::ScanResult &result) override {
+		Record(dbbenchmark::DBOperation::SCAN, table, startkey, dbbenchmark::RecordView());
+		for (int i = 0; i < recordcount; ++i) {
+			Fill(fields, result.emplace_back());
+		}
+		return StatusOf(dbbenchmark::DBOperation::SCAN, startkey);
+	}
+	dbbenchmark::utility::Status update(const std::string &table, std::string_view key,
+	                           dbbenchmark::RecordView values) override {
+		Record(dbbenchmark::DBOperation::UPDATE, table, key, values);
+		return StatusOf(dbbenchmark::DBOperation::UPDATE, key);
+	}
+	dbbenchmark::utility::Status insert(const std::string &table, std::string_view key,
+	                           dbbenchmark::RecordView values) override {
+		Record(dbbenchmark::DBOperation::INSERT, table, key, values);
+		return StatusOf(dbbenchmark::DBOperation::INSERT, key);
+	}
+	dbbenchmark::utility::Status Delete(const std::string &table, std::string_view key) override {
+		Record(dbbenchmark::DBOperation::DELETE, table, key, dbbenchmark::RecordView());
+		return StatusOf(dbbenchmark::DBOperation::DELETE, key);
+	}
+	dbbenchmark::utility::Status batchInsert(const std::string &table,
+	                                const std::vector<dbbenchmark::KeyedRecord> &records) override {
+		if (recording) {
+			batches.emplace_back(table, records.size());
+		}
+		return dbbenchmark::DB::batchInsert(table, records);
+	}
+	std::size_t pipelineDepth() const override { return depth; }
+
+	bool recording;
+	std::vector<RecordedCall> calls;
+	std::vector<std::pair<std::string, std::size_t>> batches; /// Table and size of each batchInsert()
+	std::size_t resultFields;
+	std::string value;
+	dbbenchmark::utility::Status status;
+	std::vector<std::string> failingKeys;
+	std::vector<dbbenchmark::DBOperation::Type> failingTypes;
+	std::size_t depth;
+
+private:
+	void Record(dbbenchmark::DBOperation::Type type, const std::string &table, std::string_view key,
+	            dbbenchmark::RecordView values) {
+		if (!recording) {
+			return;
+		}
+		calls.push_back({type, table, std::string(key), {}});
+		for (const dbbenchmark::FieldValue &field : values) {
+			calls.back().values.emplace_back(std::string(field.field), std::string(field.value));
+		}
+	}
+	void Fill(dbbenchmark::FieldList fields, dbbenchmark::ReadResult &result) {
+		std::size_t count = (fields.empty() ? resultFields : fields.size());
+		for (std::size_t i = 0; i < count; ++i) {
+			std::pair<std::string, std::string> &field = result.emplace_back();
+			if (fields.empty()) {
+				field.first.assign("field");
+				field.first.push_back(static_cast<char>('0' + i));
+			} else {
+				field.first.assign(fields[i]);
+			}
+			field.second.assign(value);
+		}
+	}
+	dbbenchmark::utility::Status StatusOf(dbbenchmark::DBOperation::Type type, std::string_view key) const {
+		for (const std::string &failing : failingKeys) {
+			if (failing == key) {
+				return dbbenchmark::utility::Status::ERROR;
+			}
+		}
+		for (dbbenchmark::DBOperation::Type failing : failingTypes) {
+			if (failing == type) {
+				return dbbenchmark::utility::Status::ERROR;
+			}
+		}
+		return status;
+	}
+};
+
+} // namespace workloadtesthelper
+} // namespace test
+
+#endif // _DBBENCHMARK_WORKLOADTESTHELPER_H_
@@ -0,0 +1,126 @@
+// ValuePoolTest.h
+
+#ifndef _DBBENCHMARK_VALUEPOOLTEST_H_
+#define _DBBENCHMARK_VALUEPOOLTEST_H_
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "Core/Utility/ValuePool.h"
+
+using namespace dbbenchmark::utility;
+
+namespace test {
+namespace valuepooltest {
+
+class ValuePoolTest  : public ::testing::Test {
+	virtual void SetUp() { return; }
+	virtual void TearDown() { return; }
+};
+
+TEST_F(ValuePoolTest, PrintableAndVaried) {
+	ValuePool pool(42);
+	EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(pool.data()) % ValuePool::kCacheLineSize);
+	std::set<char> characters;
+	for(std::size_t i = 0; i < ValuePool::kPoolSize; i++) {
+		ASSERT_TRUE(pool.data()[i] >= '!' && pool.data()[i] <= '~');
+		characters.insert(pool.data()[i]);
+	}
+	EXPECT_EQ(94u, characters.size());
+}
+
+TEST_F(ValuePoolTest, SlicesStayInPool) {
+	ValuePool pool(7);
+	const std::size_t lengths[] = {1, 100, 4096, ValuePool::kPoolSize - 1, ValuePool::kPoolSize};
+	for(std::size_t length : lengths) {
+		for(int i = 0; i < 1000; i++) {
+			const char *slice = pool.Slice(length);
+			EXPECT_GE(slice, pool.data());
+			EXPECT_LE(slice + length, pool.data() + ValuePool::kPoolSize);
+		}
+	}
+	EXPECT_THROW(pool.Slice(ValuePool::kPoolSize + 1), dbbenchmark::utility::InvalidArgumentException);
+}
+
+TEST_F(ValuePoolTest, ConsecutiveSlicesDiffer) {
+	ValuePool pool(1);
+	std::set<const char *> starts;
+	for(int i = 0; i < 200; i++)
+		starts.insert(pool.Slice(100));
+	EXPECT_EQ(200u, starts.size());
+}
+
+TEST_F(ValuePoolTest, CompressiblePiecesRepeat) {
+	ValuePool pool(3, 0.25);
+	const std::size_t raw = 25;
+	for(std::size_t start = 0; start + ValuePool::kPieceSize <= ValuePool::kPoolSize; start += ValuePool::kPieceSize) {
+		for(std::size_t i = start + raw; i < start + ValuePool::kPieceSize; i++) {
+			ASSERT_EQ(pool.data()[i - raw], pool.data()[i]);
+		}
+	}
+	// Pieces differ from each other, so values do not repeat across the pool.
+	EXPECT_NE(std::string(pool.data(), raw), std::string(pool.data() + ValuePool::kPieceSize, raw));
+}
+
+TEST_F(ValuePoolTest, IncompressibleByDefault) {
+	ValuePool pool(42);
+	ValuePool explicitRatio(42, 1.0);
+	EXPECT_EQ(1.0, pool.compression_ratio());
+	EXPECT_EQ(std::string(pool.data(), ValuePool::kPoolSize),
+			std::string(explicitRatio.data(), ValuePool::kPoolSize));
+	std::size_t repeats = 0;
+	for(std::size_t i = 25; i < ValuePool::kPieceSize; i++)
+		repeats += (pool.data()[i] == pool.data()[i - 25]);
+	EXPECT_LT(repeats, 10u);
+}
+
+TEST_F(ValuePoolTest, BinaryUsesAllBytes) {
+	ValuePool pool(5, 1.0, true);
+	EXPECT_TRUE(pool.binary());
+	std::set<unsigned char> bytes;
+	for(std::size_t i = 0; i < ValuePool::kPoolSize; i++)
+		bytes.insert(static_cast<unsigned char>(pool.data()[i]));
+	EXPECT_EQ(256u, bytes.size());
+	EXPECT_NE(ValuePool::ThreadLocal(1.0, true).data(), ValuePool::ThreadLocal(1.0).data());
+}
+
+TEST_F(ValuePoolTest, RejectsBadRatio) {
+	EXPECT_THROW(ValuePool(1, 0.0), dbbenchmark::utility::InvalidArgumentException);
+	EXPECT_THROW(ValuePool(1, 1.5), dbbenchmark::utility::InvalidArgumentException);
+}
+
+TEST_F(ValuePoolTest, ThreadLocalFollowsRatio) {
+	EXPECT_EQ(0.5, ValuePool::ThreadLocal(0.5).compression_ratio());
+	EXPECT_EQ(1.0, ValuePool::ThreadLocal().compression_ratio());
+}
+
+TEST_F(ValuePoolTest, OnePoolPerThread) {
+	const char *mine = ValuePool::ThreadLocal().data();
+	EXPECT_EQ(mine, ValuePool::ThreadLocal().data());
+	const char *other = nullptr;
+	std::thread thread([&other]() { other = ValuePool::ThreadLocal().data(); });
+	thread.join();
+	EXPECT_NE(mine, other);
+}
+
+TEST_F(ValuePoolTest, SameSeedSameValueAtPosition) {
+	ValuePool pool(21);
+	const char *mine = ValuePool::ThreadLocal(1.0, false, 21).At(12345, 100);
+	EXPECT_EQ(std::string(pool.At(12345, 100), 100), std::string(mine, 100));
+	std::string other;
+	std::thread thread([&other]() { other.assign(ValuePool::ThreadLocal(1.0, false, 21).At(12345, 100), 100); });
+	thread.join();
+	EXPECT_EQ(std::string(mine, 100), other);
+	// Positions wrap, whatever the length.
+	EXPECT_EQ(pool.data() + 7, pool.At(ValuePool::kPoolSize - 100 + 1 + 7, 100));
+	EXPECT_EQ(pool.data(), pool.At(99, ValuePool::kPoolSize));
+	EXPECT_EQ(21u, ValuePool::ThreadLocal(1.0, false, 21).seed());
+}
+
+} // namespace valuepooltest
+} // namespace test
+
+#endif // _DBBENCHMARK_VALUEPOOLTEST_H_
@@ -0,0 +1,339 @@
+// WorkloadSettingsTest.h
+
+#ifndef _DBBENCHMARK_WORKLOADSETTINGSTEST_H_
+#define _DBBENCHMARK_WORKLOADSETTINGSTEST_H_
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "Core/Generators/ScrambledZipfianGenerator.h"
+#include "Core/Workloads/CoreWorkload.h"
+#include "Utility/WorkloadTestHelper.h"
+
+using namespace dbbenchmark::workloads;
+
+namespace test {
+namespace workloadsettingstest {
+
+class WorkloadSettingsTest : public ::testing::Test {
+public:
+	WorkloadSettingsTest() {
+		settings.set("recordcount", "10");
+		settings.set("operationcount", "100");
+	}
+	~WorkloadSettingsTest() override { }
+	workloadtesthelper::ScopedSettings settings;
+	CoreWorkload workload;
+};
+
+TEST_F(WorkloadSettingsTest, TransactionKeysFollowTheChooser) {
+	settings.set("requestdistribution", "sequential");
+	workload.Init();
+	for (uint64_t i = 0; i < 25; ++i) {
+		ASSERT_EQ(i % 10, workload.NextTransactionKeyNum());
+	}
+}
+
+TEST_F(WorkloadSettingsTest, InitDropsKeysDrawnAhead) {
+	settings.set("requestdistribution", "sequential");
+	workload.Init();
+	workload.NextTransactionKeyNum();
+	workload.NextTransactionKeyNum();
+	workload.Init();
+	ASSERT_EQ(0u, workload.NextTransactionKeyNum());
+}
+
+TEST_F(WorkloadSettingsTest, EachThreadDrawsItsOwnKeys) {
+	settings.set("requestdistribution", "sequential");
+	workload.Init();
+	std::vector<uint64_t> keys[2];
+	std::vector<std::thread> threads;
+	for (std::vector<uint64_t> &thread_keys : keys) {
+		threads.emplace_back([this, &thread_keys]() {
+			for (int i = 0; i < 64; ++i) {
+				thread_keys.push_back(workload.NextTransactionKeyNum());
+			}
+		});
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+	// One ring's worth each: a thread's keys come from its own ring, so they stay in sequence.
+	for (const std::vector<uint64_t> &thread_keys : keys) {
+		for (std::size_t i = 1; i < thread_keys.size(); ++i) {
+			ASSERT_EQ((thread_keys[i - 1] + 1) % 10, thread_keys[i]);
+		}
+	}
+}
+
+TEST_F(WorkloadSettingsTest, ChoosersCoverTheWholeKeyspace) {
+	// insertstart only moves where this client inserts; existing keys start at 0.
+	settings.set("insertstart", "5");
+	settings.set("requestdistribution", "sequential");
+	workload.Init();
+	ASSERT_EQ(0u, workload.NextTransactionKeyNum());
+	settings.set("requestdistribution", "hotspot");
+	settings.set("hotspotdatafraction", "0.1");
+	settings.set("hotspotopnfraction", "1.0");
+	workload.Init();
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_EQ(0u, workload.NextTransactionKeyNum());
+	}
+}
+
+TEST_F(WorkloadSettingsTest, RejectsEmptyKeyspace) {
+	settings.set("recordcount", "0");
+	EXPECT_THROW(workload.Init(), dbbenchmark::utility::InvalidArgumentException);
+	// A negative count must not wrap around to a huge keyspace.
+	settings.set("recordcount", "-1");
+	EXPECT_THROW(workload.Init(), dbbenchmark::utility::InvalidArgumentException);
+}
+
+TEST_F(WorkloadSettingsTest, WritesDrawALengthPerField) {
+	settings.set("fieldcount", "10");
+	settings.set("fieldlength", "100");
+	settings.set("field_len_dist", "uniform");
+	settings.set("readproportion", "0");
+	settings.set("updateproportion", "0");
+	settings.set("insertproportion", "1");
+	workload.Init();
+	OperationRecord record;
+	workload.NextOperationRecord(record);
+	ASSERT_EQ(INSERT, record.operation);
+	std::vector<dbbenchmark::FieldValue> values;
+	workload.BuildValues(record, values);
+	ASSERT_EQ(10u, values.size());
+	std::set<std::size_t> lengths;
+	for (const dbbenchmark::FieldValue &value : values) {
+		lengths.insert(value.value.size());
+	}
+	EXPECT_LT(1u, lengths.size());
+	// The lengths follow from the record, so a replay writes the same ones.
+	std::vector<dbbenchmark::FieldValue> again;
+	workload.BuildValues(record, again);
+	for (std::size_t i = 0; i < values.size(); ++i) {
+		EXPECT_EQ(values[i].value.size(), again[i].value.size());
+	}
+}
+
+TEST_F(WorkloadSettingsTest, DeletesFromInsertStart) {
+	settings.set("insertstart", "5");
+	settings.set("requestdistribution", "sequential");
+	workload.Init();
+	uint64_t key_num = 0;
+	ASSERT_TRUE(workload.NextDeleteKeyNum(key_num));
+	ASSERT_EQ(5u, key_num);
+	// The other nine records are still chosen, each as often as before.
+	std::map<uint64_t, int> counts;
+	for (int i = 0; i < 90; ++i) {
+		++counts[workload.NextTransactionKeyNum()];
+	}
+	ASSERT_EQ(9u, counts.size());
+	ASSERT_EQ(0u, counts.count(5));
+	for (const std::pair<const uint64_t, int> &count : counts) {
+		EXPECT_EQ(10, count.second);
+	}
+}
+
+TEST_F(WorkloadSettingsTest, ConcurrentDeletesKeepTheLatestRecord) {
+	settings.set("recordcount", "1000");
+	workload.Init();
+	std::vector<uint64_t> keys[4];
+	std::vector<std::thread> threads;
+	for (std::vector<uint64_t> &thread_keys : keys) {
+		threads.emplace_back([this, &thread_keys]() {
+			uint64_t key_num = 0;
+			while (workload.NextDeleteKeyNum(key_num)) {
+				thread_keys.push_back(key_num);
+			}
+		});
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+	std::set<uint64_t> deleted;
+	for (const std::vector<uint64_t> &thread_keys : keys) {
+		deleted.insert(thread_keys.begin(), thread_keys.end());
+	}
+	ASSERT_EQ(999u, deleted.size());
+	ASSERT_EQ(998u, *deleted.rbegin());
+	ASSERT_EQ(999u, workload.NextTransactionKeyNum());
+}
+
+TEST_F(WorkloadSettingsTest, ChurnKeepsTheLiveSetSize) {
+	settings.set("readproportion", "0");
+	settings.set("updateproportion", "0");
+	settings.set("insertproportion", "1");
+	settings.set("churn", "true");
+	workload.Init();
+	uint64_t inserted = 0, deleted = 0;
+	OperationRecord record;
+	for (int i = 0; i < 40; ++i) {
+		workload.NextOperationRecord(record);
+		if (record.operation == INSERT) {
+			ASSERT_EQ(10 + inserted++, record.keyNum);
+			workload.AcknowledgeInsert(record.keyNum);
+		} else {
+			ASSERT_EQ(DELETE, record.operation);
+			ASSERT_EQ(deleted++, record.keyNum);
+		}
+		ASSERT_LE(10u, 10 + inserted - deleted);
+		ASSERT_GE(11u, 10 + inserted - deleted);
+	}
+	// Transactions move with the live set and reach all of it.
+	std::set<uint64_t> keys;
+	for (int i = 0; i < 1000; ++i) {
+		keys.insert(workload.NextTransactionKeyNum());
+	}
+	ASSERT_EQ(10u, keys.size());
+	ASSERT_EQ(deleted, *keys.begin());
+	ASSERT_EQ(9 + inserted, *keys.rbegin());
+}
+
+TEST_F(WorkloadSettingsTest, InsertsWhenNothingCanBeDeleted) {
+	settings.set("recordcount", "1");
+	settings.set("readproportion", "0");
+	settings.set("updateproportion", "0");
+	settings.set("deleteproportion", "1");
+	workload.Init();
+	OperationRecord record;
+	workload.NextOperationRecord(record);
+	ASSERT_EQ(INSERT, record.operation);
+	ASSERT_EQ(1u, record.keyNum);
+	workload.AcknowledgeInsert(record.keyNum);
+	workload.NextOperationRecord(record);
+	ASSERT_EQ(DELETE, record.operation);
+	ASSERT_EQ(0u, record.keyNum);
+}
+
+TEST_F(WorkloadSettingsTest, BatchSize) {
+	workload.Init();
+	EXPECT_EQ(1u, workload.batch_size());
+	settings.set("batchsize", "8");
+	workload.Init();
+	EXPECT_EQ(8u, workload.batch_size());
+	settings.set("batchsize", "0");
+	EXPECT_THROW(workload.Init(), dbbenchmark::utility::InvalidArgumentException);
+	settings.set("batchsize", "-1");
+	EXPECT_THROW(workload.Init(), dbbenchmark::utility::InvalidArgumentException);
+}
+
+TEST_F(WorkloadSettingsTest, FieldNamesAreInterned) {
+	settings.set("fieldcount", "1");
+	workload.Init();
+	const std::string &name = workload.NextFieldName();
+	dbbenchmark::FieldList fields = workload.SingleField(0);
+	ASSERT_EQ(1u, fields.size());
+	ASSERT_EQ(&workload.FieldName(0), &fields[0]);
+	ASSERT_EQ(&workload.FieldName(0), &name);
+}
+
+TEST_F(WorkloadSettingsTest, SingleTableByDefault) {
+	workload.Init();
+	ASSERT_EQ(1u, workload.table_count());
+	ASSERT_EQ(0u, workload.NextTableId());
+	ASSERT_EQ(&workload.TableName(0), &workload.NextTable());
+	std::size_t table = 1;
+	workload.NextSequenceKeyNum(table);
+	ASSERT_EQ(0u, table);
+}
+
+TEST_F(WorkloadSettingsTest, DeletesOldestLiveRecord) {
+	workload.Init();
+	uint64_t key_num = 1;
+	ASSERT_TRUE(workload.NextDeleteKeyNum(key_num));
+	ASSERT_EQ(0u, key_num);
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_LT(0u, workload.NextTransactionKeyNum());
+	}
+}
+
+TEST_F(WorkloadSettingsTest, SpecializedKeyChooser) {
+	workload.Init();
+	ASSERT_TRUE(workload.KeyChoosersAre<dbbenchmark::generators::UniformGenerator>());
+	ASSERT_FALSE(workload.KeyChoosersAre<dbbenchmark::generators::ScrambledZipfianGenerator>());
+	OperationRecord record;
+	for (int i = 0; i < 100; ++i) {
+		workload.NextOperationRecordWith<dbbenchmark::generators::UniformGenerator>(record);
+		ASSERT_EQ(0u, record.table);
+		ASSERT_GE(workload.TotalRecordCount(), record.keyNum);
+	}
+}
+
+///
+/// A workload that reads key 7 of every table, whatever its chooser says.
+///
+class FixedKeyWorkload : public CoreWorkload {
+public:
+	Operation NextOperation() override { return READ; }
+	uint64_t NextTransactionKeyNum(std::size_t) override { return 7; }
+};
+
+TEST_F(WorkloadSettingsTest, OperationRecordsUseOverriddenChoosers) {
+	FixedKeyWorkload fixed;
+	fixed.Init();
+	OperationRecord record;
+	for (int i = 0; i < 20; ++i) {
+		fixed.NextOperationRecord(record);
+		ASSERT_EQ(READ, record.operation);
+		ASSERT_EQ(7u, record.keyNum);
+	}
+}
+
+TEST_F(WorkloadSettingsTest, OnlyOwnOlderWritesAreStale) {
+	using dbbenchmark::utility::DeterministicValue;
+	settings.set("fieldcount", "1");
+	settings.set("dataintegrity", "true");
+	workload.Init();
+	OperationRecord record;
+	record.table = 0;
+	record.keyNum = 3;
+	record.fieldId = 0;
+	record.lengthSeed = 0;
+	// Each thread writes under its own id, numbering its writes from 1.
+	std::vector<dbbenchmark::FieldValue> values;
+	uint64_t versions[2][2];
+	std::vector<std::thread> threads;
+	for (uint64_t (&thread_versions)[2] : versions) {
+		threads.emplace_back([this, &record, &thread_versions]() {
+			std::vector<dbbenchmark::FieldValue> update;
+			thread_versions[0] = workload.BuildUpdate(record, update);
+			thread_versions[1] = workload.BuildUpdate(record, update);
+		});
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+	EXPECT_NE(DeterministicValue::Writer(versions[0][0]), DeterministicValue::Writer(versions[1][0]));
+	for (const uint64_t (&thread_versions)[2] : versions) {
+		EXPECT_EQ(DeterministicValue::Writer(thread_versions[0]), DeterministicValue::Writer(thread_versions[1]));
+		EXPECT_EQ(1u, DeterministicValue::Sequence(thread_versions[0]));
+		EXPECT_EQ(2u, DeterministicValue::Sequence(thread_versions[1]));
+	}
+	// Having written sequence 5 as writer 1, an earlier write of its own is
+	// stale, while another writer's value is not, however low its sequence.
+	dbbenchmark::utility::WriteVersionCache written;
+	written.Record(0, 3, dbbenchmark::utility::WriteVersionCache::kAllFields, DeterministicValue::Version(1, 5));
+	dbbenchmark::ReadResult result;
+	for (uint64_t version : {DeterministicValue::Version(1, 5), DeterministicValue::Version(1, 4),
+	                         DeterministicValue::Version(2, 1)}) {
+		std::pair<std::string, std::string> &field = result.emplace_back();
+		field.first = "field0";
+		field.second.resize(32);
+		DeterministicValue::Fill(&field.second[0], field.second.size(), 3, 0, version, false);
+	}
+	dbbenchmark::utility::VerificationCounts counts;
+	workload.VerifyRead(record, result, written, counts);
+	EXPECT_EQ(2u, counts.verified);
+	EXPECT_EQ(1u, counts.stale);
+	EXPECT_EQ(0u, counts.corrupt);
+}
+
+} // namespace workloadsettingstest
+} // namespace test
+
+#endif // _DBBENCHMARK_WORKLOADSETTINGSTEST_H_